@@ -1,6 +1,9 @@
 #version 450
 #include "../common/lighting.glsl"
 #include "../common/post_processing.glsl"
+#include "../common/ocean.glsl"
+#include "../common/depth.glsl"
+#include "../common/uniforms.glsl"
 
 layout(location = 0) in vec3 WorldPos;
 layout(location = 1) in vec3 Normal;
@@ -11,15 +14,16 @@ layout(binding = 1) uniform sampler2D NormalTexture_band0;
 layout(binding = 2) uniform sampler2D DisplacementTexture_band1;
 layout(binding = 3) uniform sampler2D NormalTexture_band1;
 layout(binding = 4) uniform samplerCube cubeMap;
-layout(binding = 5) uniform sampler2D GBufferWorldPositionTexture;
+layout(binding = 5) uniform sampler2D GBufferDepthTexture;
+layout(binding = 6) uniform sampler2D InverseDisplacementTexture_band0;
+layout(binding = 7) uniform sampler2D InverseDisplacementTexture_band1;
 
 layout (location = 0) out vec4 ColorOut;
 layout (location = 1) out vec4 UnderwaterMaskOut;
 
 uniform vec3 u_wireframeColor;
-uniform vec3 u_viewPos;
 uniform bool u_wireframe;
-uniform int u_normalMultipler;
+uniform bool u_foam;
 
 const vec3  WATER_ALBEDO = vec3(0.09, 0.12, 0.11);
 const float WATER_METALLIC = 0.0;
@@ -44,15 +48,15 @@ uniform int u_mode;
 
 const float u_nearMipDist = 50;   // distance at which LOD = 0
 const float u_farMipDist = 100;   // distance at which LOD = max
-const float u_maxMipLevel = 4.0;  // max mip count
+const float u_maxMipLevel = float(OCEAN_NORMAL_MIP_COUNT - 1);  // max mip count
 
 
 void main() {
 
     float fftResoltion_band0 = 512.0;
     float fftResoltion_band1 = 512.0;
-    float patchSize_band0 = 8.0;
-    float patchSize_band1 = 13.123;
+    float patchSize_band0 = OCEAN_PATCH_SIZE_BAND0;
+    float patchSize_band1 = OCEAN_PATCH_SIZE_BAND1;
 
     highp vec2 uv_band0 = fract(WorldPos.xz / patchSize_band0);
     highp vec2 uv_band1 = fract(WorldPos.xz / patchSize_band1);
@@ -64,34 +68,26 @@ void main() {
     const float gridCellsPerWorldUnit_band1 = 1.0 / displacementScale_band1;
 
 
-    float viewDist = length(WorldPos - u_viewPos);
+    float viewDist = length(WorldPos - frame.viewPos.xyz);
     float t = clamp((viewDist - u_nearMipDist) / (u_farMipDist - u_nearMipDist), 0.0, 1.0);
     float lod = t * u_maxMipLevel;
     //lod = clamp(lod, 1, uMaxMipLevel);
 
 
-    // Estimate band 0 position
-    vec2 bestGuessUV = uv_band0;
-    float dispX = texture(DisplacementTexture_band0, bestGuessUV).x;
-    float dispZ = texture(DisplacementTexture_band0, bestGuessUV).z;
-    vec2 estimatedDisplacement = vec2(dispX, dispZ) / gridCellsPerWorldUnit_band0;
-    vec2 estimatedWorldPosition = WorldPos.xz - estimatedDisplacement;
-    vec2 estimatedUV = fract(estimatedWorldPosition / patchSize_band0);
-    vec3 bestGuessNormal_band0 = textureLod(NormalTexture_band0, estimatedUV, lod).xyz;
-
-    // Estimate band 0 position
-    bestGuessUV = uv_band1;
-    dispX = texture(DisplacementTexture_band1, bestGuessUV).x;
-    dispZ = texture(DisplacementTexture_band1, bestGuessUV).z;
-    estimatedDisplacement = vec2(dispX, dispZ) / gridCellsPerWorldUnit_band1;
-    estimatedWorldPosition = WorldPos.xz - estimatedDisplacement;
-    estimatedUV = fract(estimatedWorldPosition / patchSize_band1);
-    //vec3 bestGuessNormal_band1 = texture(NormalTexture_band1, estimatedUV).xyz;
-    vec3 bestGuessNormal_band1 = textureLod(NormalTexture_band1, estimatedUV, lod).xyz;    
-    //vec3 bestGuessWorldPos_band1 = textureLod(DisplacementTexture_band1, estimatedUV, 0).xyz * displacementScale_band1;
+    // Undisplaced surface position per band
+    vec4 inverseDisplacement_band0 = SampleOceanInverseDisplacement(InverseDisplacementTexture_band0, WorldPos.xz, patchSize_band0);
+    vec4 inverseDisplacement_band1 = SampleOceanInverseDisplacement(InverseDisplacementTexture_band1, WorldPos.xz, patchSize_band1);
+    vec3 bestGuessNormal_band0 = DecodeOceanNormal(textureLod(NormalTexture_band0, inverseDisplacement_band0.rg, lod).rg);
+    vec3 bestGuessNormal_band1 = DecodeOceanNormal(textureLod(NormalTexture_band1, inverseDisplacement_band1.rg, lod).rg);
+    float jacobian_band0 = inverseDisplacement_band0.a;
+    float jacobian_band1 = inverseDisplacement_band1.a;
     
     vec3 normal = normalize(mix (bestGuessNormal_band0, bestGuessNormal_band1, 0.5));
-    normal *= u_normalMultipler;
+
+    // Underside of the surface
+    if (!gl_FrontFacing) {
+        normal = -normal;
+    }
 
     // Converge to up normal over distance
     float u_normalConvergeStartDist = 50;
@@ -121,7 +117,7 @@ void main() {
     vec3 lightDir = normalize(vec3(0.0, 0.2 , 0.5));
     vec3 L = normalize(lightDir);
     vec3 N = normalize(normal);
-    vec3 V = normalize(u_viewPos - WorldPos);
+    vec3 V = normalize(frame.viewPos.xyz - WorldPos);
     vec3 R = reflect(-V, N);
     float NoL = clamp(dot(N, L), 0.0, 1.0);
 
@@ -172,9 +168,15 @@ void main() {
     vec3 sssColor = subColor * radius * sss * sssFactor;
     color_linear += sssColor;
 
+    // Foam
+    if (u_foam) {
+        float foam = max(DecodeOceanFoam(jacobian_band0), DecodeOceanFoam(jacobian_band1));
+        color_linear = mix(color_linear, moonColor * 0.075, foam * 0.5);
+    }
+
 
 
-    float dist = length(u_viewPos - WorldPos);
+    float dist = length(frame.viewPos.xyz - WorldPos);
     float fogRange = u_fogEndDistance - u_fogStartDistance;
 
     // Calculate normalized distance within the fog range (0.0 at start, 1.0 at end)
@@ -203,9 +205,9 @@ void main() {
 
     
     // Gbuffer world position
-    vec2 gBufferResolution = vec2(textureSize(GBufferWorldPositionTexture, 0));
-    vec2 screenspace_uv = gl_FragCoord.xy / vec2(gBufferResolution);
-    vec3 gBufferWorldPosition = texture(GBufferWorldPositionTexture, screenspace_uv).xyz;
+    vec2 screenspace_uv = gl_FragCoord.xy / frame.viewportSize.xy;
+    float gBufferDepth = texelFetch(GBufferDepthTexture, ivec2(gl_FragCoord.xy), 0).r;
+    vec3 gBufferWorldPosition = WorldPositionFromDepth(screenspace_uv, gBufferDepth, frame.inverseProjectionView);
 
     vec3 waterSurfacePosition = WorldPos;
 
@@ -218,7 +220,7 @@ void main() {
     //    UnderwaterMaskOut.r = 1;
     //}
 
-    if (u_normalMultipler == -1) {
+    if (!gl_FrontFacing) {
         UnderwaterMaskOut.r = 0.0;
     }
 
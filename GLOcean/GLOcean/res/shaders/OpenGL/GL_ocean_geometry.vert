@@ -1,10 +1,12 @@
-#version 450
+#version 460
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 0) out vec3 vPosition;
+layout(location = 1) flat out uint vDrawIndex;
 
 uniform float u_meshSubdivisionFactor;
 
 void main () {
     vPosition = inPosition * vec3(u_meshSubdivisionFactor, 0, u_meshSubdivisionFactor);
+    vDrawIndex = gl_BaseInstance;
 }
@@ -2,7 +2,6 @@
 #include "../common/post_processing.glsl"
 
 layout (location = 0) out vec4 LightingOut;
-layout (location = 1) out vec4 WorldPositionOut;
 
 uniform samplerCube environmentMap;
 in vec3 TexCoords;
@@ -10,7 +9,6 @@ in vec4 WorldPos;
 
 void main () {
     LightingOut = texture(environmentMap, TexCoords);
-    WorldPositionOut = vec4(WorldPos.rgb, 1.0);
     //fragOut.rgb = AdjustSaturation(fragOut.rgb, -0.5);
   //  fragOut.rgb = AdjustLightness(fragOut.rgb, -0.5);
 }
@@ -0,0 +1,14 @@
+#version 460 core
+#include "../common/uniforms.glsl"
+#include "../common/vertex_format.glsl"
+
+layout (location = 0) in vec3 vPosition;
+
+// Must match gl_lighting.vert exactly so the lighting pass can depth test with GL_EQUAL
+invariant gl_Position;
+
+void main() {
+    DrawUniforms draw = drawUniforms[gl_BaseInstance];
+    vec4 worldPos = draw.model * vec4(DequantizePosition(draw, vPosition), 1.0);
+	gl_Position = frame.projectionView * worldPos;
+}
@@ -1,21 +1,26 @@
 #version 460 core
+#include "../common/uniforms.glsl"
 
 layout (location = 0) out vec4 FragOut;
 layout (binding = 0) uniform sampler2D previousDepthTexture;
+layout (binding = 1) uniform sampler2D sceneDepthTexture;
 
 in vec4 WorldPos;
-uniform mat4 view;
 uniform float nearPlane;
 uniform float farPlane;
-uniform float viewportWidth;
-uniform float viewportHeight;
 
 void main() {
  
-    vec2 uv_screenspace = gl_FragCoord.xy / vec2(viewportWidth, viewportHeight);
+    vec2 uv_screenspace = gl_FragCoord.xy / frame.viewportSize.zw;
     float previousDepth = texture2D(previousDepthTexture, uv_screenspace).r;
+    float sceneDepth = texture2D(sceneDepthTexture, uv_screenspace).r;
 
-    float viewspaceDepth = (view * WorldPos).z;
+    // Occluded by the scene
+    if (gl_FragCoord.z >= sceneDepth) {
+        discard;
+    }
+
+    float viewspaceDepth = (frame.view * WorldPos).z;
     float normalizedDepth = (viewspaceDepth - (-farPlane)) / ((-nearPlane) - (-farPlane));    
 
     if (normalizedDepth >= previousDepth) {
@@ -1,14 +1,13 @@
 #version 460 core
+#include "../common/uniforms.glsl"
+#include "../common/vertex_format.glsl"
 
 layout (location = 0) in vec3 vPosition;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
-
 out vec4 WorldPos;
 
 void main() {
-    WorldPos = model * vec4(vPosition, 1.0);
-	gl_Position = projection * view * WorldPos;
+    DrawUniforms draw = drawUniforms[gl_BaseInstance];
+    WorldPos = draw.model * vec4(DequantizePosition(draw, vPosition), 1.0);
+	gl_Position = frame.projectionView * WorldPos;
 }
\ No newline at end of file
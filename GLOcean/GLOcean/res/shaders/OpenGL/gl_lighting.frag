@@ -1,9 +1,11 @@
 #version 460 core
+#extension GL_ARB_bindless_texture : enable
 #include "../common/lighting.glsl"
 #include "../common/post_processing.glsl"
+#include "../common/uniforms.glsl"
 
 layout (location = 0) out vec4 LightingOut;
-layout (location = 1) out vec4 WorldPositionOut;
+layout (location = 1) out float RevealageOut;
 
 layout (binding = 0) uniform sampler2D baseColorTexture;
 layout (binding = 1) uniform sampler2D normalTexture;
@@ -14,18 +16,49 @@ in vec3 Normal;
 in vec3 Tangent;
 in vec3 BiTangent;
 in vec3 WorldPos;
+flat in uint DrawIndex;
 
-uniform vec3 viewPos;
 uniform int settings;
 uniform float viewportWidth;
 uniform float viewportHeight;
 uniform bool isHair;
+uniform bool weightedBlendedOIT;
 uniform float time;
+uniform bool bindlessTextures;
+
+#ifdef GL_ARB_bindless_texture
+// Indexed by texture index, zero until the texture has finished baking
+layout(std430, binding = 11) readonly buffer TextureHandlesBuffer {
+    uvec2 textureHandles[];
+};
+
+vec4 SampleBindless(uint textureIndex, vec4 fallback) {
+    uvec2 handle = textureHandles[textureIndex];
+    if (handle == uvec2(0)) {
+        return fallback;
+    }
+    return texture(sampler2D(handle), TexCoord);
+}
+#endif
 
 void main() {
-    vec4 baseColor = texture2D(baseColorTexture, TexCoord);
-    vec3 normalMap = texture2D(normalTexture, TexCoord).rgb;
-    vec3 rma = texture2D(rmaTexture, TexCoord).rgb;
+    vec4 baseColor;
+    vec3 normalMap;
+    vec3 rma;
+#ifdef GL_ARB_bindless_texture
+    if (bindlessTextures) {
+        uvec4 materialIndices = drawUniforms[DrawIndex].materialIndices;
+        baseColor = SampleBindless(materialIndices.x, vec4(0.5, 0.5, 0.5, 1.0));
+        normalMap = SampleBindless(materialIndices.y, vec4(0.5, 0.5, 1.0, 1.0)).rgb;
+        rma = SampleBindless(materialIndices.z, vec4(0.5, 0.0, 1.0, 1.0)).rgb;
+    }
+    else
+#endif
+    {
+        baseColor = texture2D(baseColorTexture, TexCoord);
+        normalMap = texture2D(normalTexture, TexCoord).rgb;
+        rma = texture2D(rmaTexture, TexCoord).rgb;
+    }
 	baseColor.rgb = pow(baseColor.rgb, vec3(2.2));
 
     
@@ -46,7 +79,7 @@ void main() {
     lightStrength = 1;
     lightRadius = 10;
 		
-    vec3 directLighting = GetDirectLighting(lightPosition, lightColor, lightRadius, lightStrength, normal, WorldPos.xyz, baseColor.rgb, roughness, metallic, viewPos);
+    vec3 directLighting = GetDirectLighting(lightPosition, lightColor, lightRadius, lightStrength, normal, WorldPos.xyz, baseColor.rgb, roughness, metallic, frame.viewPos.xyz);
 
     // Ambient light
     vec3 amibentLightColor = vec3(1, 0.98, 0.94);
@@ -73,5 +106,12 @@ void main() {
 
     finalColor.rgb = finalColor.rgb * finalAlpha;
     LightingOut = vec4(finalColor, finalAlpha);
-    WorldPositionOut = vec4(WorldPos.xyz, 1);
+
+    // Weighted blended OIT, depth weight from McGuire and Bavoil 2013
+    if (weightedBlendedOIT) {
+        float viewspaceDepth = 1.0 / gl_FragCoord.w;
+        float weight = finalAlpha * clamp(10.0 / (0.00001 + pow(viewspaceDepth / 5.0, 2.0) + pow(viewspaceDepth / 200.0, 6.0)), 0.01, 3000.0);
+        LightingOut *= weight;
+        RevealageOut = finalAlpha;
+    }
 }
@@ -0,0 +1,6 @@
+// World space position for a [0, 1] screen space uv and depth buffer value
+vec3 WorldPositionFromDepth(vec2 uv, float depth, mat4 inverseProjectionView) {
+    vec4 clipSpacePosition = vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 worldSpacePosition = inverseProjectionView * clipSpacePosition;
+    return worldSpacePosition.xyz / worldSpacePosition.w;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+// World size of one FFT patch, must match Ocean::GetPatchWorldSize()
+const float OCEAN_PATCH_SIZE_BAND0 = 8.0;
+const float OCEAN_PATCH_SIZE_BAND1 = 13.123;
+
+// Levels written by GL_ocean_update_textures.comp, 16x16 work group down to 1x1
+const int OCEAN_NORMAL_MIP_COUNT = 5;
+
+// Ocean normals always point up, so only xz is stored and y is rebuilt
+vec2 EncodeOceanNormal(vec3 normal) {
+    return normal.xz;
+}
+
+vec3 DecodeOceanNormal(vec2 encoded) {
+    return vec3(encoded.x, sqrt(max(1.0 - dot(encoded, encoded), 0.0)), encoded.y);
+}
+
+// Jacobian is stored in the displacement alpha when foam is enabled
+float DecodeOceanFoam(float jacobian) {
+    return clamp((0.8 - jacobian) * 2.0, 0.0, 1.0);
+}
+
+// One fetch resolves the displaced surface above a world position, see GL_ocean_inverse_displacement.comp
+// Returns rg = source UV, b = world space height, a = jacobian
+vec4 SampleOceanInverseDisplacement(sampler2D inverseDisplacementTexture, vec2 worldXZ, float patchSize) {
+    vec2 uv = fract(worldXZ / patchSize);
+    vec4 inverseDisplacement = texture(inverseDisplacementTexture, uv);
+    return vec4(fract(uv + inverseDisplacement.rg), inverseDisplacement.ba);
+}
+
+// Camera local clipmap holding all bands resampled into world space, see GL_ocean_clipmap.comp.
+// Must match Ocean::GetClipmapLevelCount() / GetClipmapResolution()
+const int OCEAN_CLIPMAP_LEVEL_COUNT = 9;
+const int OCEAN_CLIPMAP_RESOLUTION = 256;
+const float OCEAN_CLIPMAP_BASE_SIZE = 4.0;      // World size covered by level 0, each level doubles it
+const float OCEAN_CLIPMAP_USABLE_RATIO = 0.45;  // Fraction of a level's extent (from its center) that is sampled
+
+float OceanClipmapTexelSize(int level) {
+    return OCEAN_CLIPMAP_BASE_SIZE * float(1 << level) / float(OCEAN_CLIPMAP_RESOLUTION);
+}
+
+// Snapped to the level's own texel grid so the resampled waves don't swim as the camera moves
+vec2 OceanClipmapOrigin(int level, vec2 center) {
+    float texelSize = OceanClipmapTexelSize(level);
+    return floor(center / texelSize) * texelSize - texelSize * float(OCEAN_CLIPMAP_RESOLUTION / 2);
+}
+
+vec2 OceanClipmapTexelToWorld(ivec2 texelCoords, int level, vec2 center) {
+    return OceanClipmapOrigin(level, center) + (vec2(texelCoords) + 0.5) * OceanClipmapTexelSize(level);
+}
+
+int GetOceanClipmapLevel(vec2 worldXZ, vec2 center) {
+    vec2 offset = abs(worldXZ - center);
+    float dist = max(offset.x, offset.y);
+    float level = ceil(log2(max(dist / (OCEAN_CLIPMAP_BASE_SIZE * OCEAN_CLIPMAP_USABLE_RATIO), 1.0)));
+    return min(int(level), OCEAN_CLIPMAP_LEVEL_COUNT - 1);
+}
+
+vec4 SampleOceanClipmapLevel(sampler2DArray clipmap, vec2 worldXZ, vec2 center, int level) {
+    vec2 uv = (worldXZ - OceanClipmapOrigin(level, center)) / (OceanClipmapTexelSize(level) * float(OCEAN_CLIPMAP_RESOLUTION));
+    return textureLod(clipmap, vec3(uv, float(level)), 0);
+}
+
+// One fetch, two only across the thin blend region at the outer edge of a level
+vec4 SampleOceanClipmap(sampler2DArray clipmap, vec2 worldXZ, vec2 center) {
+    int level = GetOceanClipmapLevel(worldXZ, center);
+    vec4 result = SampleOceanClipmapLevel(clipmap, worldXZ, center, level);
+
+    vec2 offset = abs(worldXZ - center);
+    float ratio = max(offset.x, offset.y) / (OCEAN_CLIPMAP_BASE_SIZE * OCEAN_CLIPMAP_USABLE_RATIO * float(1 << level));
+    float blend = smoothstep(0.85, 1.0, ratio);
+    if (blend > 0.0 && level + 1 < OCEAN_CLIPMAP_LEVEL_COUNT) {
+        result = mix(result, SampleOceanClipmapLevel(clipmap, worldXZ, center, level + 1), blend);
+    }
+    return result;
+}
@@ -0,0 +1,23 @@
+// Matches FrameUniforms and DrawUniforms in GL_renderer.cpp
+
+struct DrawUniforms {
+    mat4 model;
+    mat4 normalMatrix;
+    uvec4 materialIndices;  // base color, normal, rma texture indices
+    vec4 positionOffset;    // xyz = static mesh AABB min
+    vec4 positionScale;     // xyz = static mesh AABB size
+};
+
+layout(std140, binding = 0) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    mat4 inverseProjectionView;
+    vec4 viewPos;           // w = time
+    vec4 viewportSize;      // xy = render resolution, zw = render target size
+} frame;
+
+// Indexed by the base instance of each draw
+layout(std430, binding = 10) readonly buffer DrawUniformsBuffer {
+    DrawUniforms drawUniforms[];
+};
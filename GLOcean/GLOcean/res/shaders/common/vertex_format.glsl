@@ -0,0 +1,15 @@
+// Decoding for CompactVertex in HellTypes.h, as laid out by OpenGLMeshBuffer
+
+// Positions arrive as unorm16 across the mesh AABB
+vec3 DequantizePosition(DrawUniforms draw, vec3 position) {
+    return draw.positionOffset.xyz + position * draw.positionScale.xyz;
+}
+
+// Normals and tangents arrive as octahedral x and y, snorm10 each
+vec3 OctahedralDecode(vec2 e) {
+    vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
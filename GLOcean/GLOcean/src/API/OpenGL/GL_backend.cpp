@@ -7,6 +7,7 @@
 #include <vector>
 #include "HellTypes.h"
 #include "GL_util.hpp"
+#include "../Tools/MeshTools.h"
 
 namespace OpenGLBackend {
 
@@ -28,10 +29,58 @@ namespace OpenGLBackend {
     const size_t MAX_DATA_SIZE = MAX_TEXTURE_WIDTH * MAX_TEXTURE_HEIGHT * MAX_CHANNEL_COUNT;
     std::vector<PBO> g_textureBakingPBOs;
 
+    OpenGLMeshBuffer g_staticMeshBuffer;
+
     GLFWwindow* GetWindowPtr() {
         return g_window;
     }
 
+    // Quantized against the mesh AABB, so that must be set first
+    void UploadStaticMesh(OpenGLDetachedMesh& mesh, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        int baseVertex = 0;
+        int baseIndex = 0;
+        glm::vec3 aabbMin = mesh.aabbMin;
+        glm::vec3 aabbMax = glm::max(mesh.aabbMax, mesh.aabbMin);
+        std::vector<CompactVertex> compactVertices = MeshTools::QuantizeVertices(vertices, aabbMin, aabbMax);
+        g_staticMeshBuffer.AddMesh(compactVertices, indices, baseVertex, baseIndex);
+        mesh.SetSharedBufferLocation(vertices, indices, baseVertex, baseIndex);
+        mesh.SetQuantization(aabbMin, aabbMax - aabbMin);
+    }
+
+    // LODs reuse the vertices already uploaded for the mesh, only their indices are added
+    void UploadStaticMeshLod(OpenGLDetachedMesh& mesh, const std::vector<uint32_t>& indices, float error) {
+        if (!mesh.IsInSharedBuffer() || indices.empty()) {
+            return;
+        }
+        int baseIndex = g_staticMeshBuffer.AddIndices(indices);
+        mesh.AddLod(baseIndex, (int)indices.size(), error);
+    }
+
+    void UploadStaticMeshMeshlets(OpenGLDetachedMesh& mesh, const std::vector<Meshlet>& meshlets) {
+        if (!mesh.IsInSharedBuffer() || meshlets.empty()) {
+            return;
+        }
+        std::vector<OpenGLMeshlet> gpuMeshlets(meshlets.size());
+        for (size_t i = 0; i < meshlets.size(); i++) {
+            const Meshlet& meshlet = meshlets[i];
+            OpenGLMeshlet& gpuMeshlet = gpuMeshlets[i];
+            gpuMeshlet.centerRadius = glm::vec4(meshlet.center, meshlet.radius);
+            gpuMeshlet.coneAxisCutoff = glm::vec4(meshlet.coneAxis, meshlet.coneCutoff);
+            gpuMeshlet.firstIndex = (uint32_t)mesh.GetBaseIndex() + meshlet.indexOffset;
+            gpuMeshlet.indexCount = meshlet.indexCount;
+        }
+        int meshletOffset = g_staticMeshBuffer.AddMeshlets(gpuMeshlets);
+        mesh.SetMeshlets(meshletOffset, (int)meshlets.size());
+    }
+
+    GLuint GetStaticMeshVAO() {
+        return g_staticMeshBuffer.GetVAO();
+    }
+
+    GLuint GetStaticMeshletBuffer() {
+        return g_staticMeshBuffer.GetMeshletBuffer();
+    }
+
     void Init(std::string title) {
         glfwInit();
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
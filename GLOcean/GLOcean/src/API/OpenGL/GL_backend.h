@@ -3,9 +3,12 @@
 #include <GLFW/glfw3.h>
 #include <string>
 #include <iostream>
+#include "Types/GL_detachedMesh.hpp"
+#include "Types/GL_meshBuffer.hpp"
 #include "Types/GL_pbo.hpp"
 #include "Types/GL_texture.h"
 #include "../Types/Texture.h"
+#include "../File/FileFormats.h"
 
 enum class WindowedMode { WINDOWED, FULLSCREEN };
 
@@ -29,4 +32,11 @@ namespace OpenGLBackend {
     void AllocateTextureMemory(Texture& texture);
     void ImmediateBake(QueuedTextureBake& queuedTextureBake);
     void AsyncBakeQueuedTextureBake(QueuedTextureBake& queuedTextureBake);
+
+    // Meshes
+    void UploadStaticMesh(OpenGLDetachedMesh& mesh, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+    void UploadStaticMeshLod(OpenGLDetachedMesh& mesh, const std::vector<uint32_t>& indices, float error);
+    void UploadStaticMeshMeshlets(OpenGLDetachedMesh& mesh, const std::vector<Meshlet>& meshlets);
+    GLuint GetStaticMeshVAO();
+    GLuint GetStaticMeshletBuffer();
 }
\ No newline at end of file
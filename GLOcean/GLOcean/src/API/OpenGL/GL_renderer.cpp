@@ -1,12 +1,16 @@
 #include "GL_renderer.h"
 #include "GL_backend.h"
+#include "GL_state.hpp"
 #include "GL_util.hpp"
 #include "Types/GL_detachedMesh.hpp"
 #include "Types/GL_frameBuffer.h"
 #include "Types/GL_mesh_patch.h"
 #include "Types/GL_pbo.hpp"
+#include "Types/GL_readbackBuffer.hpp"
+#include "Types/GL_ringBuffer.hpp"
 #include "Types/GL_shader.h"
 #include "Types/GL_ssbo.h"
+#include "Types/GL_timerQuery.hpp"
 #include "../AssetManagement/AssetManager.h"
 #include "../Core/Audio.h"
 #include "../Core/Camera.h"
@@ -32,13 +36,19 @@ namespace OpenGLRenderer {
         Shader textBlitter;
         Shader hairfinalComposite;
         Shader hairLayerComposite;
+        Shader hairOITResolve;
         Shader skybox;
         Shader oceanGeometry;
         Shader oceanWireframe;
         Shader oceanCalculateSpectrum;
         Shader oceanUpdateTextures;
+        Shader oceanInverseDisplacement;
+        Shader oceanClipmap;
         Shader oceanSurfaceComposite;
         Shader underwaterTest;
+        Shader occlusionDepth;
+        Shader depthPrepass;
+        Shader meshletCull;
 
         Shader ftt_radix_a;
         Shader ftt_radix_b;
@@ -58,6 +68,39 @@ namespace OpenGLRenderer {
         OpenGLFrameBuffer water;
     } g_frameBuffers;
 
+    // Matches uniforms.glsl
+    struct FrameUniforms {
+        glm::mat4 projection;
+        glm::mat4 view;
+        glm::mat4 projectionView;
+        glm::mat4 inverseProjectionView;
+        glm::vec4 viewPos;
+        glm::vec4 viewportSize;
+    };
+
+    struct DrawUniforms {
+        glm::mat4 model;
+        glm::mat4 normalMatrix;
+        glm::uvec4 materialIndices;
+        glm::vec4 positionOffset; // Dequantizes static mesh positions, xyz only
+        glm::vec4 positionScale;
+    };
+
+    struct DrawElementsIndirectCommand {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t baseInstance;
+    };
+
+    struct TimerQueries {
+        OpenGLTimerQuery oceanGeometry;
+        OpenGLTimerQuery hair;
+        OpenGLTimerQuery lighting;
+        OpenGLTimerQuery frame;
+    } g_timerQueries;
+
 
     Skybox g_skybox;
     OpenGLMeshPatch g_tesselationPatch;
@@ -75,22 +118,91 @@ namespace OpenGLRenderer {
     OpenGLSSBO g_fftGradXOutSSBO;
     OpenGLSSBO g_fftGradZOutSSBO;
 
+    GLuint g_oceanClipmapDisplacement = 0;
+    GLuint g_oceanClipmapNormals = 0;
+
+    // Per frame camera data at UBO binding 0, per draw data at SSBO binding 10 indexed by gl_BaseInstance
+    constexpr uint32_t MAX_DRAWS_PER_FRAME = 8192;
+    constexpr uint32_t INVALID_DRAW_INDEX = 0xFFFFFFFF; // Returned by PushDrawUniforms() when the ring is full, skip the draw
+    OpenGLRingBuffer g_frameUniformsRing;
+    OpenGLRingBuffer g_drawUniformsRing;
+    uint32_t g_drawUniformsCount = 0;
+    bool g_drawUniformsOverflowReported = false;
+    OpenGLRingBuffer g_indirectCommandsRing;
+    uint32_t g_indirectCommandCount = 0;
+
+    constexpr int OCCLUSION_TILES_X = 128;
+    constexpr int OCCLUSION_TILES_Y = 64;
+    OpenGLReadbackBuffer g_occlusionDepthReadback;
+    glm::mat4 g_occlusionProjectionViews[OpenGLReadbackBuffer::FRAME_COUNT];
+    uint64_t g_occlusionWriteFrames[OpenGLReadbackBuffer::FRAME_COUNT] = {};
+    uint64_t g_frameNumber = 0;
+    bool g_depthPrepass = true;
+
+    // Meshlet culling, jobs are (meshlet, draw index, base vertex) and the survivors are drawn with a GPU written count
+    constexpr uint32_t MAX_MESHLET_JOBS_PER_FRAME = 32768;
+    OpenGLRingBuffer g_meshletJobsRing;
+    uint32_t g_meshletJobCount = 0;
+    OpenGLSSBO g_meshletDrawCommandsSSBO;
+    OpenGLSSBO g_meshletDrawCountSSBO;
+    uint32_t g_culledMeshletJobCount = 0;
+    bool g_meshletCulling = true;
+
+    // Bindless handle per texture index at SSBO binding 11, falls back to binding each item's textures
+    bool g_bindlessTexturesSupported = false;
+    bool g_bindlessTextures = false;
+    OpenGLSSBO g_textureHandlesSSBO;
+    std::vector<GLuint64> g_textureHandles;
+
     int g_mode = 0;
     float g_globalTime = 50.0f;
+    OceanTextureFormat g_oceanTextureFormat = OceanTextureFormat::HALF_PRECISION;
+    bool g_oceanJacobian = false;
+    HairRenderMode g_hairRenderMode = HairRenderMode::DEPTH_PEELING;
+
+    // Dynamic resolution, main/water/hair render into the bottom left of their targets at this scale
+    constexpr float TARGET_GPU_FRAME_TIME = 1000.0f / 60.0f;
+    constexpr float MIN_RESOLUTION_SCALE = 0.5f;
+    constexpr float MAX_RESOLUTION_SCALE = 1.0f;
+    bool g_dynamicResolution = false;
+    float g_resolutionScale = 1.0f;
 
     void InitOceanGPUState();
-    void DrawScene(Shader& shader);
+    void DrawScene(uint32_t opaqueBaseDrawIndex);
     void ComputeOceanFFT();
     void RenderOcean();
     void RenderLighting();
     void RenderDebug();
     void RenderHair();
     void RenderHairLayer(std::vector<RenderItem>& renderItems, int peelCount);
+    void RenderHairLayerWeightedBlended(std::vector<RenderItem>& renderItems);
     void RenderText();
     void RenderSkyBox();
     void UnderwaterTest();
 
     void BlitFrameBuffer(OpenGLFrameBuffer* srcFrameBuffer, OpenGLFrameBuffer* dstFrameBuffer, const char* srcName, const char* dstName, GLbitfield mask, GLenum filter);
+    void BlitFrameBuffer(OpenGLFrameBuffer* srcFrameBuffer, OpenGLFrameBuffer* dstFrameBuffer, const char* srcName, const char* dstName, glm::ivec2 srcSize, GLbitfield mask, GLenum filter);
+    void CreateOceanTextures();
+    GLenum GetOceanDisplacementFormat();
+    GLenum GetOceanNormalsFormat();
+    void PrintOceanTextureFootprint();
+    void UpdateOceanClipmap(glm::vec3 viewPos);
+    void ResizeRenderTargets(int width, int height);
+    void UpdateResolutionScale();
+    glm::ivec2 GetRenderSize();
+    void SetRenderViewport();
+    void UpdateFrameUniforms();
+    DrawUniforms* ReserveDrawUniforms(uint32_t count, uint32_t& baseDrawIndex);
+    uint32_t PushDrawUniforms(const glm::mat4& modelMatrix);
+    uint32_t PushDrawUniforms(const RenderItem& renderItem);
+    uint32_t PushDrawUniforms(const std::vector<RenderItem>& renderItems);
+    void MultiDrawRenderItems(std::vector<RenderItem>& renderItems, uint32_t baseDrawIndex, bool bindTextures);
+    bool CullMeshlets(std::vector<RenderItem>& renderItems, uint32_t baseDrawIndex);
+    void MultiDrawCulledMeshlets(std::vector<RenderItem>& renderItems, bool bindTextures);
+    void BenchmarkUniformUpload();
+    void UpdateBindlessTextureHandles();
+    void ReadBackOcclusionDepth();
+    void WriteOcclusionDepth();
     //void ComputeInverseFFT(GLuint inputHandle, GLuint outputHandle);
 
     void Init() {
@@ -98,7 +210,6 @@ namespace OpenGLRenderer {
 
         g_frameBuffers.main.Create("Main", 1920, 1080);
         g_frameBuffers.main.CreateAttachment("Color", GL_RGBA8);
-        g_frameBuffers.main.CreateAttachment("WorldPosition", GL_RGBA32F);
         g_frameBuffers.main.CreateDepthAttachment(GL_DEPTH32F_STENCIL8);
 
         g_frameBuffers.water.Create("Water", 1920, 1080);
@@ -108,34 +219,58 @@ namespace OpenGLRenderer {
 
         g_frameBuffers.downSamplesQuarter.Create("DownSamples", 1920 / 4, 1080 / 4);
         g_frameBuffers.downSamplesQuarter.CreateAttachment("FinalLighting", GL_RGBA8);
+
         
 
         float hairDownscaleRatio = 1.0f;
         g_frameBuffers.hair.Create("Hair", g_frameBuffers.main.GetWidth() * hairDownscaleRatio, g_frameBuffers.main.GetHeight() * hairDownscaleRatio);
         g_frameBuffers.hair.CreateDepthAttachment(GL_DEPTH32F_STENCIL8);
         g_frameBuffers.hair.CreateAttachment("Color", GL_RGBA8);
-        g_frameBuffers.hair.CreateAttachment("ViewspaceDepth", GL_R32F);
-        g_frameBuffers.hair.CreateAttachment("ViewspaceDepthPrevious", GL_R32F);
+        g_frameBuffers.hair.CreateAttachment("ViewspaceDepthA", GL_R32F);
+        g_frameBuffers.hair.CreateAttachment("ViewspaceDepthB", GL_R32F);
         g_frameBuffers.hair.CreateAttachment("Composite", GL_RGBA8);
+        g_frameBuffers.hair.CreateAttachment("OITAccumulation", GL_RGBA16F);
+        g_frameBuffers.hair.CreateAttachment("OITRevealage", GL_R16F);
 
-        g_frameBuffers.fft_band0.Create("FFT", Ocean::GetFFTResolution(0).x, Ocean::GetFFTResolution(0).y);
-        g_frameBuffers.fft_band0.CreateAttachment("Displacement", GL_RGBA32F, GL_LINEAR, GL_LINEAR, GL_REPEAT);
-        g_frameBuffers.fft_band0.CreateAttachment("Normals", GL_RGBA32F, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, true);
-
-        g_frameBuffers.fft_band1.Create("FFT2", Ocean::GetFFTResolution(1).x, Ocean::GetFFTResolution(1).y);
-        g_frameBuffers.fft_band1.CreateAttachment("Displacement", GL_RGBA32F, GL_LINEAR, GL_LINEAR, GL_REPEAT, true);
-        g_frameBuffers.fft_band1.CreateAttachment("Normals", GL_RGBA32F, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, true);
+        CreateOceanTextures();
 
         g_frameBuffers.finalImage.Create("Main", g_frameBuffers.main.GetWidth() * 0.5f, g_frameBuffers.main.GetHeight() * 0.5f);
         g_frameBuffers.finalImage.CreateAttachment("Color", GL_RGBA8);
 
         LoadShaders();
 
+        g_frameUniformsRing.PreAllocate(sizeof(FrameUniforms));
+        g_drawUniformsRing.PreAllocate(sizeof(DrawUniforms) * MAX_DRAWS_PER_FRAME);
+        g_indirectCommandsRing.PreAllocate(sizeof(DrawElementsIndirectCommand) * MAX_DRAWS_PER_FRAME);
+        g_occlusionDepthReadback.PreAllocate(sizeof(float) * OCCLUSION_TILES_X * OCCLUSION_TILES_Y);
+        g_meshletJobsRing.PreAllocate(sizeof(glm::uvec4) * MAX_MESHLET_JOBS_PER_FRAME);
+        g_meshletDrawCommandsSSBO.PreAllocate(sizeof(DrawElementsIndirectCommand) * MAX_MESHLET_JOBS_PER_FRAME, 0);
+        g_meshletDrawCountSSBO.PreAllocate(sizeof(uint32_t), GL_MAP_READ_BIT);
+
+        g_bindlessTexturesSupported = OpenGLUtil::ExtensionExists("GL_ARB_bindless_texture");
+        g_bindlessTextures = g_bindlessTexturesSupported;
+        std::cout << "Bindless textures: " << (g_bindlessTexturesSupported ? "supported" : "not supported, binding per draw") << "\n";
+
         g_skybox.Init();
     }
 
     void RenderFrame() {
 
+        // Targets follow the window, the resolution scale only moves the viewport inside them
+        int windowWidth = OpenGLBackend::GetWindowWidth();
+        int windowHeight = OpenGLBackend::GetWindowHeight();
+        if (windowWidth > 0 && windowHeight > 0 && (windowWidth != g_frameBuffers.finalImage.GetWidth() || windowHeight != g_frameBuffers.finalImage.GetHeight())) {
+            ResizeRenderTargets(windowWidth, windowHeight);
+        }
+        OpenGLState::BeginFrame();
+        UpdateResolutionScale();
+        UpdateFrameUniforms();
+        UpdateBindlessTextureHandles();
+        ReadBackOcclusionDepth();
+        if (Input::KeyPressed(HELL_KEY_F1)) {
+            BenchmarkUniformUpload();
+        }
+        g_timerQueries.frame.Begin();
 
         static int band = 1;
 
@@ -197,14 +332,14 @@ namespace OpenGLRenderer {
         //std::cout << "RenderFrame()\n";
 
         g_frameBuffers.water.Bind();
-        g_frameBuffers.water.SetViewport();
+        SetRenderViewport();
         g_frameBuffers.water.DrawBuffers({ "Color", "UnderwaterMask" });
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         g_frameBuffers.main.Bind();
-        g_frameBuffers.main.SetViewport();
-        g_frameBuffers.main.DrawBuffers({ "Color", "WorldPosition" });
+        SetRenderViewport();
+        g_frameBuffers.main.DrawBuffers({ "Color" });
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -220,9 +355,10 @@ namespace OpenGLRenderer {
         ComputeOceanFFT();
         RenderSkyBox();
         RenderLighting();
+        WriteOcclusionDepth();
 
 
-        BlitFrameBuffer(&g_frameBuffers.main, &g_frameBuffers.downSamplesQuarter, "Color", "FinalLighting", GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        BlitFrameBuffer(&g_frameBuffers.main, &g_frameBuffers.downSamplesQuarter, "Color", "FinalLighting", GetRenderSize(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
 
         RenderOcean();
 
@@ -233,12 +369,10 @@ namespace OpenGLRenderer {
         OpenGLFrameBuffer& mainFrameBuffer = g_frameBuffers.main;
         OpenGLFrameBuffer& hairFrameBuffer = g_frameBuffers.hair;
         g_shaders.hairfinalComposite.Use();
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, hairFrameBuffer.GetColorAttachmentHandleByName("Composite"));
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, mainFrameBuffer.GetColorAttachmentHandleByName("Color"));
+        OpenGLState::BindTexture(0, hairFrameBuffer.GetColorAttachmentHandleByName("Composite"));
+        OpenGLState::BindTexture(1, mainFrameBuffer.GetColorAttachmentHandleByName("Color"));
         glBindImageTexture(0, mainFrameBuffer.GetColorAttachmentHandleByName("Color"), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
-        glDispatchCompute((g_frameBuffers.main.GetWidth() + 7) / 8, (g_frameBuffers.main.GetHeight() + 7) / 8, 1);
+        glDispatchCompute((GetRenderSize().x + 7) / 8, (GetRenderSize().y + 7) / 8, 1);
         glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 
         UnderwaterTest();
@@ -255,8 +389,9 @@ namespace OpenGLRenderer {
 
         //g_frameBuffers.main.BlitToDefaultFrameBuffer("Color", 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
-        // Downscale blit
-        BlitFrameBuffer(&g_frameBuffers.main, &g_frameBuffers.finalImage, "Color", "Color", GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        // Upscale blit
+        BlitFrameBuffer(&g_frameBuffers.main, &g_frameBuffers.finalImage, "Color", "Color", GetRenderSize(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        g_timerQueries.frame.End();
 
         // Blit to swapchain
         g_frameBuffers.finalImage.BlitToDefaultFrameBuffer("Color", 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
@@ -286,68 +421,186 @@ namespace OpenGLRenderer {
             g_frameBuffers.fft_band1.BlitToDefaultFrameBuffer("Normals", 0, 0, height, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
         }
 
+        g_frameUniformsRing.EndFrame();
+        g_drawUniformsRing.EndFrame();
+        g_indirectCommandsRing.EndFrame();
+        g_meshletJobsRing.EndFrame();
+        g_frameNumber++;
+
         glfwSwapBuffers(OpenGLBackend::GetWindowPtr());
         glfwPollEvents();
     }
 
     void CopyDepthBuffer(OpenGLFrameBuffer& srcFrameBuffer, OpenGLFrameBuffer& dstFrameBuffer) {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, srcFrameBuffer.GetHandle());
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dstFrameBuffer.GetHandle());
+        OpenGLState::BindFramebuffer(GL_READ_FRAMEBUFFER, srcFrameBuffer.GetHandle());
+        OpenGLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, dstFrameBuffer.GetHandle());
         glBlitFramebuffer(0, 0, srcFrameBuffer.GetWidth(), srcFrameBuffer.GetHeight(), 0, 0, dstFrameBuffer.GetWidth(), dstFrameBuffer.GetHeight(), GL_DEPTH_BUFFER_BIT, GL_NEAREST);
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        OpenGLState::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        OpenGLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
 
     void CopyColorBuffer(OpenGLFrameBuffer& srcFrameBuffer, OpenGLFrameBuffer& dstFrameBuffer, const char* srcAttachmentName, const char* dstAttachmentName) {
         GLenum srcAttachmentSlot = srcFrameBuffer.GetColorAttachmentSlotByName(srcAttachmentName);
         GLenum dstAttachmentSlot = dstFrameBuffer.GetColorAttachmentSlotByName(dstAttachmentName);
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, srcFrameBuffer.GetHandle());
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dstFrameBuffer.GetHandle());
+        OpenGLState::BindFramebuffer(GL_READ_FRAMEBUFFER, srcFrameBuffer.GetHandle());
+        OpenGLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, dstFrameBuffer.GetHandle());
         glReadBuffer(srcAttachmentSlot);
         glDrawBuffer(dstAttachmentSlot);
         glBlitFramebuffer(0, 0, srcFrameBuffer.GetWidth(), srcFrameBuffer.GetHeight(), 0, 0, dstFrameBuffer.GetWidth(), dstFrameBuffer.GetHeight(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        OpenGLState::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        OpenGLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
 
-    void DrawScene(Shader& shader) {
-        // Non blended
-        for (RenderItem& renderItem : Scene::GetRenderItems()) {
+    void DrawScene(uint32_t opaqueBaseDrawIndex) {
+        // Non blended, with the prepass depth already laid down only the visible surface passes GL_EQUAL
+        if (g_depthPrepass) {
+            OpenGLState::DepthFunc(GL_EQUAL);
+            OpenGLState::DepthMask(GL_FALSE);
+        }
+        if (opaqueBaseDrawIndex != INVALID_DRAW_INDEX) {
+            MultiDrawRenderItems(Scene::GetRenderItems(), opaqueBaseDrawIndex, !g_bindlessTextures);
+        }
+        OpenGLState::DepthFunc(GL_LESS);
+        OpenGLState::DepthMask(GL_TRUE);
+
+        // Blended
+        OpenGLState::Enable(GL_BLEND);
+        OpenGLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        OpenGLState::Disable(GL_CULL_FACE);
+        OpenGLState::DepthMask(GL_FALSE);
+        uint32_t baseDrawIndex = PushDrawUniforms(Scene::GetRenderItemsBlended());
+        if (baseDrawIndex != INVALID_DRAW_INDEX) {
+            MultiDrawRenderItems(Scene::GetRenderItemsBlended(), baseDrawIndex, !g_bindlessTextures);
+        }
+        OpenGLState::DepthMask(GL_TRUE);
+        OpenGLState::Disable(GL_BLEND);
+        OpenGLState::Enable(GL_CULL_FACE);
+    }
+
+    void BindRenderItemTextures(const RenderItem& renderItem) {
+        OpenGLState::BindTexture(0, AssetManager::GetTextureByIndex(renderItem.baseColorTextureIndex)->GetGLTexture().GetHandle());
+        OpenGLState::BindTexture(1, AssetManager::GetTextureByIndex(renderItem.normalTextureIndex)->GetGLTexture().GetHandle());
+        OpenGLState::BindTexture(2, AssetManager::GetTextureByIndex(renderItem.rmaTextureIndex)->GetGLTexture().GetHandle());
+    }
+
+    bool RenderItemTexturesMatch(const RenderItem& a, const RenderItem& b) {
+        return a.baseColorTextureIndex == b.baseColorTextureIndex && a.normalTextureIndex == b.normalTextureIndex && a.rmaTextureIndex == b.rmaTextureIndex;
+    }
+
+    void MultiDrawRenderItems(std::vector<RenderItem>& renderItems, uint32_t baseDrawIndex, bool bindTextures) {
+        DrawElementsIndirectCommand* commands = (DrawElementsIndirectCommand*)g_indirectCommandsRing.GetSegmentPointer();
+        if (!commands) {
+            return;
+        }
+        OpenGLState::BindVertexArray(OpenGLBackend::GetStaticMeshVAO());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g_indirectCommandsRing.GetHandle());
+
+        // One multi draw per bucket. A bucket is the whole list, or a run of items sharing textures when they must be bound
+        uint32_t bucketStart = g_indirectCommandCount;
+        auto submitBucket = [&]() {
+            uint32_t commandCount = g_indirectCommandCount - bucketStart;
+            if (commandCount > 0) {
+                size_t offset = g_indirectCommandsRing.GetSegmentOffset() + bucketStart * sizeof(DrawElementsIndirectCommand);
+                glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)offset, commandCount, 0);
+            }
+            bucketStart = g_indirectCommandCount;
+        };
+
+        const RenderItem* bucketItem = nullptr;
+        for (int i = 0; i < renderItems.size(); i++) {
+            RenderItem& renderItem = renderItems[i];
             OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(renderItem.meshIndex);
-            if (mesh) {
-                shader.SetMat4("model", renderItem.modelMatrix);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.baseColorTextureIndex)->GetGLTexture().GetHandle());
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.normalTextureIndex)->GetGLTexture().GetHandle());
-                glActiveTexture(GL_TEXTURE2);
-                glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.rmaTextureIndex)->GetGLTexture().GetHandle());
-                glBindVertexArray(mesh->GetVAO());
-                glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
+            if (!mesh || !mesh->IsInSharedBuffer()) {
+                continue;
+            }
+            if (g_indirectCommandCount >= MAX_DRAWS_PER_FRAME) {
+                std::cout << "MultiDrawRenderItems() failed because MAX_DRAWS_PER_FRAME (" << MAX_DRAWS_PER_FRAME << ") was exceeded\n";
+                break;
+            }
+            if (bindTextures && (!bucketItem || !RenderItemTexturesMatch(*bucketItem, renderItem))) {
+                submitBucket();
+                BindRenderItemTextures(renderItem);
+                bucketItem = &renderItem;
             }
+            DrawElementsIndirectCommand& command = commands[g_indirectCommandCount++];
+            command.count = mesh->GetLodIndexCount(renderItem.lodIndex);
+            command.instanceCount = 1;
+            command.firstIndex = mesh->GetLodBaseIndex(renderItem.lodIndex);
+            command.baseVertex = mesh->GetBaseVertex();
+            command.baseInstance = baseDrawIndex + i;
         }
-        // Blended
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDisable(GL_CULL_FACE);
-        glDepthMask(GL_FALSE);
-        for (RenderItem& renderItem : Scene::GetRenderItemsBlended()) {
+        submitBucket();
+    }
+
+    // Frustum, backface cone and occlusion culling per meshlet on the GPU. Returns false if the items can't take this
+    // path (no meshlets, a reduced LOD, or mixed textures without bindless), the caller then draws them whole
+    bool CullMeshlets(std::vector<RenderItem>& renderItems, uint32_t baseDrawIndex) {
+        if (!g_meshletCulling || renderItems.empty()) {
+            return false;
+        }
+        uint32_t jobCount = 0;
+        for (RenderItem& renderItem : renderItems) {
             OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(renderItem.meshIndex);
-            if (mesh) {
-                shader.SetMat4("model", renderItem.modelMatrix);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.baseColorTextureIndex)->GetGLTexture().GetHandle());
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.normalTextureIndex)->GetGLTexture().GetHandle());
-                glActiveTexture(GL_TEXTURE2);
-                glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.rmaTextureIndex)->GetGLTexture().GetHandle());
-                glBindVertexArray(mesh->GetVAO());
-                glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
+            if (!mesh || !mesh->IsInSharedBuffer() || mesh->GetMeshletCount() == 0 || renderItem.lodIndex != 0) {
+                return false;
+            }
+            // Surviving meshlets of every item share one multi draw, so textures can only be bound once
+            if (!g_bindlessTextures && !RenderItemTexturesMatch(renderItems[0], renderItem)) {
+                return false;
+            }
+            jobCount += mesh->GetMeshletCount();
+        }
+        glm::uvec4* jobs = (glm::uvec4*)g_meshletJobsRing.GetSegmentPointer();
+        if (!jobs) {
+            return false;
+        }
+        if (g_meshletJobCount + jobCount > MAX_MESHLET_JOBS_PER_FRAME) {
+            std::cout << "CullMeshlets() failed because MAX_MESHLET_JOBS_PER_FRAME (" << MAX_MESHLET_JOBS_PER_FRAME << ") was exceeded\n";
+            return false;
+        }
+        uint32_t firstJob = g_meshletJobCount;
+        for (int i = 0; i < renderItems.size(); i++) {
+            OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(renderItems[i].meshIndex);
+            for (int j = 0; j < mesh->GetMeshletCount(); j++) {
+                jobs[g_meshletJobCount++] = glm::uvec4(mesh->GetMeshletOffset() + j, baseDrawIndex + i, mesh->GetBaseVertex(), 0);
             }
         }
-        glDepthMask(GL_TRUE);
-        glDisable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+
+        // Tiles are only current if the occlusion depth pass ran this frame
+        bool occlusionCulling = Scene::OcclusionCullingEnabled() && g_occlusionWriteFrames[g_occlusionDepthReadback.GetLastWriteIndex()] == g_frameNumber;
+        uint32_t zero = 0;
+        glClearNamedBufferData(g_meshletDrawCountSSBO.GetHandle(), GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+        g_shaders.meshletCull.Use();
+        g_shaders.meshletCull.SetInt("u_firstJob", (int)firstJob);
+        g_shaders.meshletCull.SetInt("u_jobCount", (int)jobCount);
+        g_shaders.meshletCull.SetBool("u_frustumCulling", true);
+        g_shaders.meshletCull.SetBool("u_coneCulling", true);
+        g_shaders.meshletCull.SetBool("u_occlusionCulling", occlusionCulling);
+        g_shaders.meshletCull.SetUvec2("u_tileCount", glm::uvec2(OCCLUSION_TILES_X, OCCLUSION_TILES_Y));
+        if (occlusionCulling) {
+            g_occlusionDepthReadback.BindLastWriteRange(GL_SHADER_STORAGE_BUFFER, 12);
+        }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 13, OpenGLBackend::GetStaticMeshletBuffer());
+        g_meshletJobsRing.BindRange(GL_SHADER_STORAGE_BUFFER, 14);
+        g_meshletDrawCommandsSSBO.Bind(15);
+        g_meshletDrawCountSSBO.Bind(16);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        glDispatchCompute((jobCount + 63) / 64, 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+        g_culledMeshletJobCount = jobCount;
+        return true;
+    }
+
+    // Draws whatever the last CullMeshlets() kept, the draw count is read from the GPU
+    void MultiDrawCulledMeshlets(std::vector<RenderItem>& renderItems, bool bindTextures) {
+        if (bindTextures) {
+            BindRenderItemTextures(renderItems[0]);
+        }
+        OpenGLState::BindVertexArray(OpenGLBackend::GetStaticMeshVAO());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g_meshletDrawCommandsSSBO.GetHandle());
+        glBindBuffer(GL_PARAMETER_BUFFER, g_meshletDrawCountSSBO.GetHandle());
+        glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, (GLsizei)g_culledMeshletJobCount, 0);
     }
 
 
@@ -357,20 +610,39 @@ namespace OpenGLRenderer {
         time += 1.0f / 60.0f;
 
         g_frameBuffers.main.Bind();
-        g_frameBuffers.main.SetViewport();
-        g_frameBuffers.main.DrawBuffers({ "Color", "WorldPosition" });
+        SetRenderViewport();
+        g_frameBuffers.main.DrawBuffers({ "Color" });
+
+        OpenGLState::Enable(GL_CULL_FACE);
+        OpenGLState::Enable(GL_DEPTH_TEST);
+
+        if (Input::KeyPressed(HELL_KEY_F6)) {
+            g_timerQueries.lighting.Print(std::string("Scene lighting GPU (depth prepass ") + (g_depthPrepass ? "ON)" : "OFF)"));
+            g_timerQueries.lighting.Reset();
+            g_depthPrepass = !g_depthPrepass;
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            std::cout << "Depth prepass: " << (g_depthPrepass ? "ON" : "OFF") << "\n";
+        }
+        g_timerQueries.lighting.Begin();
+
+        // The opaque draw uniforms are shared by the prepass and the lighting pass
+        uint32_t opaqueBaseDrawIndex = PushDrawUniforms(Scene::GetRenderItems());
+        if (g_depthPrepass && opaqueBaseDrawIndex != INVALID_DRAW_INDEX) {
+            g_shaders.depthPrepass.Use();
+            OpenGLState::DepthFunc(GL_LESS);
+            OpenGLState::DepthMask(GL_TRUE);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            MultiDrawRenderItems(Scene::GetRenderItems(), opaqueBaseDrawIndex, false);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        }
 
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
         g_shaders.lighting.Use();
-        g_shaders.lighting.SetMat4("projection", Camera::GetProjectionMatrix());
-        g_shaders.lighting.SetMat4("view", Camera::GetViewMatrix());
-        g_shaders.lighting.SetMat4("model", glm::mat4(1));
-        g_shaders.lighting.SetVec3("viewPos", Camera::GetViewPos());
         g_shaders.lighting.SetFloat("time", time);
+        g_shaders.lighting.SetBool("bindlessTextures", g_bindlessTextures);
         g_shaders.lighting.SetFloat("viewportWidth", g_frameBuffers.hair.GetWidth());
         g_shaders.lighting.SetFloat("viewportHeight", g_frameBuffers.hair.GetHeight());
-        DrawScene(g_shaders.lighting);
+        DrawScene(opaqueBaseDrawIndex);
+        g_timerQueries.lighting.End();
     }
 
 
@@ -383,20 +655,48 @@ namespace OpenGLRenderer {
         if (Input::KeyPressed(HELL_KEY_8) && peelCount < 7) {
             Audio::PlayAudio("UI_Select.wav", 1.0f);
             peelCount++;
+            g_timerQueries.hair.Reset();
             std::cout << "Depth peel layer count: " << peelCount << "\n";
         }
         if (Input::KeyPressed(HELL_KEY_9) && peelCount > 0) {
             Audio::PlayAudio("UI_Select.wav", 1.0f);
             peelCount--;
+            g_timerQueries.hair.Reset();
             std::cout << "Depth peel layer count: " << peelCount << "\n";
         }
+        if (Input::KeyPressed(HELL_KEY_C)) {
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            g_hairRenderMode = (HairRenderMode)(((int)g_hairRenderMode + 1) % (int)HairRenderMode::COUNT);
+            g_timerQueries.hair.Reset();
+            std::cout << "Hair render mode: " << (g_hairRenderMode == HairRenderMode::DEPTH_PEELING ? "depth peeling" : "weighted blended OIT") << "\n";
+        }
+        if (Input::KeyPressed(HELL_KEY_F8)) {
+            // Meshlets drawn by the last cull, a blocking read but only on the key press
+            uint32_t drawnMeshletCount = 0;
+            g_meshletDrawCountSSBO.CopyTo(&drawnMeshletCount, sizeof(uint32_t));
+            g_timerQueries.hair.Print(std::string("Hair GPU (meshlet culling ") + (g_meshletCulling ? "ON, " + std::to_string(drawnMeshletCount) + "/" + std::to_string(g_culledMeshletJobCount) + " meshlets drawn)" : "OFF)"));
+            g_timerQueries.hair.Reset();
+            g_meshletCulling = !g_meshletCulling;
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            std::cout << "Meshlet culling: " << (g_meshletCulling ? "ON" : "OFF") << "\n";
+        }
+        if (Input::KeyPressed(HELL_KEY_P)) {
+            if (g_hairRenderMode == HairRenderMode::DEPTH_PEELING) {
+                g_timerQueries.hair.Print("Hair GPU (depth peeling, " + std::to_string(peelCount) + " layers)");
+            }
+            else {
+                g_timerQueries.hair.Print("Hair GPU (weighted blended OIT)");
+            }
+        }
         // Blit debug text
         int viewportWidth = mainFrameBuffer.GetWidth();
         int viewportHeight = mainFrameBuffer.GetHeight();
         int locationX = 0;
         int locationY = 0;
         float scale = 2.0f;
-        std::string text = "Cam pos: " + Util::Vec3ToString(Camera::GetViewPos());
+        std::string text = "Cam pos: " + Util::Vec3ToString(Camera::GetFrameData().viewPos);
+        text += "\n" + OpenGLState::LastFrameCountersToString();
+        text += "\n" + Scene::GetCullingStatsString();
         //text += "\n";
         //text += "\n";
         //text += Ocean::FFTBandToString(0);
@@ -410,112 +710,152 @@ namespace OpenGLRenderer {
         shader->SetBool("isHair", true);
         g_frameBuffers.hair.Bind();
         g_frameBuffers.hair.ClearAttachment("Composite", 0, 0, 0, 0);
-        g_frameBuffers.hair.SetViewport();
-        glEnable(GL_CULL_FACE);
-        glDisable(GL_BLEND);
+        SetRenderViewport();
+        OpenGLState::Enable(GL_CULL_FACE);
+        OpenGLState::Disable(GL_BLEND);
 
         // Render all top then all Bottom layers
-        RenderHairLayer(Scene::GetRenderItemsHairTopLayer(), peelCount);
-        RenderHairLayer(Scene::GetRenderItemsHairBottomLayer(), peelCount);
+        g_timerQueries.hair.Begin();
+        if (g_hairRenderMode == HairRenderMode::DEPTH_PEELING) {
+            RenderHairLayer(Scene::GetRenderItemsHairTopLayer(), peelCount);
+            RenderHairLayer(Scene::GetRenderItemsHairBottomLayer(), peelCount);
+        }
+        else {
+            RenderHairLayerWeightedBlended(Scene::GetRenderItemsHairTopLayer());
+            RenderHairLayerWeightedBlended(Scene::GetRenderItemsHairBottomLayer());
+        }
+        g_timerQueries.hair.End();
 
         g_shaders.hairfinalComposite.Use();
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, hairFrameBuffer.GetColorAttachmentHandleByName("Composite"));
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, mainFrameBuffer.GetColorAttachmentHandleByName("Color"));
+        OpenGLState::BindTexture(0, hairFrameBuffer.GetColorAttachmentHandleByName("Composite"));
+        OpenGLState::BindTexture(1, mainFrameBuffer.GetColorAttachmentHandleByName("Color"));
         glBindImageTexture(0, mainFrameBuffer.GetColorAttachmentHandleByName("Color"), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
-        glDispatchCompute((g_frameBuffers.main.GetWidth() + 7) / 8, (g_frameBuffers.main.GetHeight() + 7) / 8, 1);
+        glDispatchCompute((GetRenderSize().x + 7) / 8, (GetRenderSize().y + 7) / 8, 1);
 
         // Cleanup
         shader->Use();
         shader->SetBool("isHair", false);
-        g_frameBuffers.main.SetViewport();
-        glDepthFunc(GL_LESS);
+        SetRenderViewport();
+        OpenGLState::DepthFunc(GL_LESS);
     }
 
     void RenderHairLayer(std::vector<RenderItem>& renderItems, int peelCount) {
+        // Peel layers alternate between these, each one reading the depth written by the last
+        const char* viewspaceDepthAttachments[2] = { "ViewspaceDepthA", "ViewspaceDepthB" };
+
+        // Every peel draws the same items, so their draw uniforms and visible meshlets are worked out once up front
+        uint32_t baseDrawIndex = PushDrawUniforms(renderItems);
+        if (baseDrawIndex == INVALID_DRAW_INDEX) {
+            return;
+        }
+        bool meshletsCulled = CullMeshlets(renderItems, baseDrawIndex);
+
         g_frameBuffers.hair.Bind();
-        g_frameBuffers.hair.ClearAttachment("ViewspaceDepthPrevious", 1, 1, 1, 1);
+        g_frameBuffers.hair.ClearAttachment(viewspaceDepthAttachments[1], 1, 1, 1, 1);
         for (int i = 0; i < peelCount; i++) {
-            // Viewspace depth pass
-            CopyDepthBuffer(g_frameBuffers.main, g_frameBuffers.hair);
+            const char* viewspaceDepth = viewspaceDepthAttachments[i % 2];
+            const char* viewspaceDepthPrevious = viewspaceDepthAttachments[(i + 1) % 2];
+
+            // Viewspace depth pass, scene occlusion is tested in the shader against main depth so only a clear is needed here
             g_frameBuffers.hair.Bind();
-            g_frameBuffers.hair.ClearAttachment("ViewspaceDepth", 0, 0, 0, 0);
-            g_frameBuffers.hair.DrawBuffer("ViewspaceDepth");
-            glDepthFunc(GL_LESS);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, g_frameBuffers.hair.GetColorAttachmentHandleByName("ViewspaceDepthPrevious"));
+            g_frameBuffers.hair.ClearAttachment(viewspaceDepth, 0, 0, 0, 0);
+            g_frameBuffers.hair.DrawBuffer(viewspaceDepth);
+            OpenGLState::DepthMask(GL_TRUE);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            OpenGLState::DepthFunc(GL_LESS);
+            OpenGLState::BindTexture(0, g_frameBuffers.hair.GetColorAttachmentHandleByName(viewspaceDepthPrevious));
+            OpenGLState::BindTexture(1, g_frameBuffers.main.GetDepthAttachmentHandle());
             Shader* shader = &g_shaders.hairDepthPeel;
             shader->Use();
-            shader->SetMat4("projection", Camera::GetProjectionMatrix());
-            shader->SetMat4("view", Camera::GetViewMatrix());
             shader->SetFloat("nearPlane", NEAR_PLANE);
             shader->SetFloat("farPlane", FAR_PLANE);
-            shader->SetFloat("viewportWidth", g_frameBuffers.hair.GetWidth());
-            shader->SetFloat("viewportHeight", g_frameBuffers.hair.GetHeight());
-            for (RenderItem& renderItem : renderItems) {
-                OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(renderItem.meshIndex);
-                if (mesh) {
-                    shader->SetMat4("model", renderItem.modelMatrix);
-                    glBindVertexArray(mesh->GetVAO());
-                    glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
-                }
+            if (meshletsCulled) {
+                MultiDrawCulledMeshlets(renderItems, false);
+            }
+            else {
+                MultiDrawRenderItems(renderItems, baseDrawIndex, false);
             }
             // Color pass
-            glDepthFunc(GL_EQUAL);
+            OpenGLState::DepthFunc(GL_EQUAL);
             g_frameBuffers.hair.Bind();
             g_frameBuffers.hair.ClearAttachment("Color", 0, 0, 0, 0);
             g_frameBuffers.hair.DrawBuffer("Color");
             shader = &g_shaders.lighting;
             shader->Use();
-            shader->SetMat4("projection", Camera::GetProjectionMatrix());
-            shader->SetMat4("view", Camera::GetViewMatrix());
-            for (RenderItem& renderItem : renderItems) {
-                OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(renderItem.meshIndex);
-                if (mesh) {
-                    shader->SetMat4("model", renderItem.modelMatrix);
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.baseColorTextureIndex)->GetGLTexture().GetHandle());
-                    glActiveTexture(GL_TEXTURE1);
-                    glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.normalTextureIndex)->GetGLTexture().GetHandle());
-                    glActiveTexture(GL_TEXTURE2);
-                    glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByIndex(renderItem.rmaTextureIndex)->GetGLTexture().GetHandle());
-                    glBindVertexArray(mesh->GetVAO());
-                    glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
-                }
+            if (meshletsCulled) {
+                MultiDrawCulledMeshlets(renderItems, !g_bindlessTextures);
+            }
+            else {
+                MultiDrawRenderItems(renderItems, baseDrawIndex, !g_bindlessTextures);
             }
-            // TODO!: when you port this to the main engine you can output previous viewspace depth in the pass above
-            CopyColorBuffer(g_frameBuffers.hair, g_frameBuffers.hair, "ViewspaceDepth", "ViewspaceDepthPrevious");
-
             // Composite
             g_shaders.hairLayerComposite.Use();
             glBindImageTexture(0, g_frameBuffers.hair.GetColorAttachmentHandleByName("Color"), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
             glBindImageTexture(1, g_frameBuffers.hair.GetColorAttachmentHandleByName("Composite"), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
-            glDispatchCompute((g_frameBuffers.hair.GetWidth() + 7) / 8, (g_frameBuffers.hair.GetHeight() + 7) / 8, 1);
+            glDispatchCompute((GetRenderSize().x + 7) / 8, (GetRenderSize().y + 7) / 8, 1);
+        }
+    }
+
+    void RenderHairLayerWeightedBlended(std::vector<RenderItem>& renderItems) {
+        // Accumulate every fragment in one pass, tested against but not writing scene depth
+        CopyDepthBuffer(g_frameBuffers.main, g_frameBuffers.hair);
+        g_frameBuffers.hair.Bind();
+        g_frameBuffers.hair.ClearAttachment("OITAccumulation", 0, 0, 0, 0);
+        g_frameBuffers.hair.ClearAttachment("OITRevealage", 1, 1, 1, 1);
+        g_frameBuffers.hair.DrawBuffers({ "OITAccumulation", "OITRevealage" });
+        OpenGLState::DepthFunc(GL_LESS);
+        OpenGLState::DepthMask(GL_FALSE);
+        OpenGLState::Enable(GL_BLEND);
+        OpenGLState::BlendFunci(0, GL_ONE, GL_ONE);
+        OpenGLState::BlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+
+        Shader* shader = &g_shaders.lighting;
+        shader->Use();
+        shader->SetBool("weightedBlendedOIT", true);
+        uint32_t baseDrawIndex = PushDrawUniforms(renderItems);
+        if (baseDrawIndex != INVALID_DRAW_INDEX) {
+            if (CullMeshlets(renderItems, baseDrawIndex)) {
+                shader->Use();
+                MultiDrawCulledMeshlets(renderItems, !g_bindlessTextures);
+            }
+            else {
+                MultiDrawRenderItems(renderItems, baseDrawIndex, !g_bindlessTextures);
+            }
         }
+        shader->SetBool("weightedBlendedOIT", false);
+        OpenGLState::DepthMask(GL_TRUE);
+        OpenGLState::Disable(GL_BLEND);
+
+        // Resolve into the composite
+        g_shaders.hairOITResolve.Use();
+        OpenGLState::BindTexture(0, g_frameBuffers.hair.GetColorAttachmentHandleByName("OITAccumulation"));
+        OpenGLState::BindTexture(1, g_frameBuffers.hair.GetColorAttachmentHandleByName("OITRevealage"));
+        glBindImageTexture(0, g_frameBuffers.hair.GetColorAttachmentHandleByName("Composite"), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
+        glDispatchCompute((GetRenderSize().x + 7) / 8, (GetRenderSize().y + 7) / 8, 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
     }
 
     void RenderDebug() {
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_CULL_FACE);
+        OpenGLState::Enable(GL_DEPTH_TEST);
+        OpenGLState::Disable(GL_CULL_FACE);
         glPointSize(8.0f);
-        glDisable(GL_DEPTH_TEST);
+        OpenGLState::Disable(GL_DEPTH_TEST);
 
         g_shaders.solidColor.Use();
-        g_shaders.solidColor.SetMat4("projection", Camera::GetProjectionMatrix());
-        g_shaders.solidColor.SetMat4("view", Camera::GetViewMatrix());
+        g_shaders.solidColor.SetMat4("projection", Camera::GetFrameData().projection);
+        g_shaders.solidColor.SetMat4("view", Camera::GetFrameData().view);
         g_shaders.solidColor.SetMat4("model", glm::mat4(1));
 
         // Draw lines
         UpdateDebugLinesMesh();
         if (g_debugLinesMesh.GetIndexCount() > 0) {
-            glBindVertexArray(g_debugLinesMesh.GetVAO());
+            OpenGLState::BindVertexArray(g_debugLinesMesh.GetVAO());
             glDrawElements(GL_LINES, g_debugLinesMesh.GetIndexCount(), GL_UNSIGNED_INT, 0);
         }
         // Draw points
         UpdateDebugPointsMesh();
         if (g_debugPointsMesh.GetIndexCount() > 0) {
-            glBindVertexArray(g_debugPointsMesh.GetVAO());
+            OpenGLState::BindVertexArray(g_debugPointsMesh.GetVAO());
             glDrawElements(GL_POINTS, g_debugPointsMesh.GetIndexCount(), GL_UNSIGNED_INT, 0);
         }
     }
@@ -523,23 +863,22 @@ namespace OpenGLRenderer {
     void RenderText() {
         OpenGLFrameBuffer& mainFrameBuffer = g_frameBuffers.main;
         mainFrameBuffer.Bind();
-        mainFrameBuffer.SetViewport();
+        SetRenderViewport();
 
         Shader& shader = g_shaders.textBlitter;
         shader.Use();
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        OpenGLState::Disable(GL_DEPTH_TEST);
+        OpenGLState::Enable(GL_BLEND);
+        OpenGLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         OpenGLFontMesh* fontMesh = TextBlitter::GetGLFontMesh("StandardFont");
         if (fontMesh) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByName("StandardFont")->GetGLTexture().GetHandle());
-            glBindVertexArray(fontMesh->GetVAO());
+            OpenGLState::BindTexture(0, AssetManager::GetTextureByName("StandardFont")->GetGLTexture().GetHandle());
+            OpenGLState::BindVertexArray(fontMesh->GetVAO());
             glDrawElements(GL_TRIANGLES, fontMesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
         }
 
         // Cleanup
-        glDisable(GL_BLEND);
+        OpenGLState::Disable(GL_BLEND);
     }
 
     void InitOceanGPUState() {
@@ -548,6 +887,19 @@ namespace OpenGLRenderer {
 
         g_tesselationPatch.Resize2(Ocean::GetTesslationMeshSize().x, Ocean::GetTesslationMeshSize().y);
 
+        // Camera local clipmap, one layer per level
+        int clipmapResolution = Ocean::GetClipmapResolution();
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &g_oceanClipmapDisplacement);
+        glTextureStorage3D(g_oceanClipmapDisplacement, 1, GL_RGBA16F, clipmapResolution, clipmapResolution, Ocean::GetClipmapLevelCount());
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &g_oceanClipmapNormals);
+        glTextureStorage3D(g_oceanClipmapNormals, 1, GL_RG16F, clipmapResolution, clipmapResolution, Ocean::GetClipmapLevelCount());
+        for (GLuint texture : { g_oceanClipmapDisplacement, g_oceanClipmapNormals }) {
+            glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
         GLbitfield staticFlags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT;
         GLbitfield dynamicFlags = GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT;
 
@@ -664,15 +1016,13 @@ namespace OpenGLRenderer {
             Ocean::ComputeInverseFFT2D(fftResolution.x, g_fftDispZInSSBO.GetHandle(), g_fftDispZOutSSBO.GetHandle());
             Ocean::ComputeInverseFFT2D(fftResolution.x, g_fftGradXInSSBO.GetHandle(), g_fftGradXOutSSBO.GetHandle());
             Ocean::ComputeInverseFFT2D(fftResolution.x, g_fftGradZInSSBO.GetHandle(), g_fftGradZOutSSBO.GetHandle());
+            OpenGLState::Invalidate(); // GLFFT binds its own programs and textures
 
-            // Update mesh position
-            if (i == 0) {
-                glBindImageTexture(0, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Displacement"), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
-                glBindImageTexture(1, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Normals"), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
-            }
-            if (i == 1) {
-                glBindImageTexture(0, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Displacement"), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
-                glBindImageTexture(1, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Normals"), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+            // Update mesh position and the normal mip chain
+            OpenGLFrameBuffer& fftFrameBuffer = (i == 0) ? g_frameBuffers.fft_band0 : g_frameBuffers.fft_band1;
+            glBindImageTexture(0, fftFrameBuffer.GetColorAttachmentHandleByName("Displacement"), 0, GL_FALSE, 0, GL_WRITE_ONLY, GetOceanDisplacementFormat());
+            for (int level = 0; level < Ocean::GetNormalMipCount(); level++) {
+                glBindImageTexture(1 + level, fftFrameBuffer.GetColorAttachmentHandleByName("Normals"), level, GL_FALSE, 0, GL_WRITE_ONLY, GetOceanNormalsFormat());
             }
             glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, g_fftSpectrumOutSSBO.GetHandle());
             glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, g_fftDispXOutSSBO.GetHandle());
@@ -683,10 +1033,25 @@ namespace OpenGLRenderer {
             g_shaders.oceanUpdateTextures.SetUvec2("u_fftGridSize", fftResolution);
             g_shaders.oceanUpdateTextures.SetFloat("u_dispScale", Ocean::GetDisplacementScale());
             g_shaders.oceanUpdateTextures.SetFloat("u_heightScale", Ocean::GetHeightScale());
+            g_shaders.oceanUpdateTextures.SetBool("u_writeJacobian", g_oceanJacobian);
 
             glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
             glDispatchCompute(blockSizeX, blockSizeY, 1);
         }
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        // Inverse displacement, lets screen space passes find the water height with a single fetch per band
+        g_shaders.oceanInverseDisplacement.Use();
+        for (int i = 0; i < bandCount; i++) {
+            const glm::uvec2 fftResolution = Ocean::GetFFTResolution(i);
+            OpenGLFrameBuffer& fftFrameBuffer = (i == 0) ? g_frameBuffers.fft_band0 : g_frameBuffers.fft_band1;
+            g_shaders.oceanInverseDisplacement.SetUvec2("u_fftGridSize", fftResolution);
+            g_shaders.oceanInverseDisplacement.SetFloat("u_patchSize", Ocean::GetPatchWorldSize(i));
+            OpenGLState::BindTexture(0, fftFrameBuffer.GetColorAttachmentHandleByName("Displacement"));
+            glBindImageTexture(0, fftFrameBuffer.GetColorAttachmentHandleByName("InverseDisplacement"), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+            glDispatchCompute((fftResolution.x + 15) / 16, (fftResolution.y + 15) / 16, 1);
+        }
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
     }
 
     void CheckGLErrors(const char* context) {
@@ -712,8 +1077,30 @@ namespace OpenGLRenderer {
         static bool wireframe = false;
         static bool swap = false;
         static bool test = false;
-      
+        static bool singlePass = true;
 
+        if (Input::KeyPressed(HELL_KEY_O)) {
+            singlePass = !singlePass;
+            g_timerQueries.oceanGeometry.Reset();
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            std::cout << "Ocean surface: " << (singlePass ? "single two-sided pass" : "two culled passes") << "\n";
+        }
+        if (Input::KeyPressed(HELL_KEY_L)) {
+            g_oceanTextureFormat = (OceanTextureFormat)(((int)g_oceanTextureFormat + 1) % (int)OceanTextureFormat::COUNT);
+            CreateOceanTextures();
+            OpenGLState::Invalidate(); // Freed texture names can be handed out again, the cached bindings would match them
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            PrintOceanTextureFootprint();
+        }
+        if (Input::KeyPressed(HELL_KEY_G)) {
+            g_oceanJacobian = !g_oceanJacobian;
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            std::cout << "Ocean foam: " << (g_oceanJacobian ? "ON" : "OFF") << "\n";
+        }
+        if (Input::KeyPressed(HELL_KEY_P)) {
+            g_timerQueries.oceanGeometry.Print("Ocean geometry GPU");
+            PrintOceanTextureFootprint();
+        }
         if (Input::KeyPressed(HELL_KEY_V)) {
             test = !test;
         }
@@ -736,10 +1123,7 @@ namespace OpenGLRenderer {
             offset = Ocean::GetBaseFFTResolution().x * scale;
         }
 
-        glm::mat4 projectionMatrix = Camera::GetProjectionMatrix();
-        glm::mat4 viewMatrix = Camera::GetViewMatrix();
-        glm::vec3 viewPos = Camera::GetViewPos();
-        glm::mat4 projectionView = projectionMatrix * viewMatrix;
+        glm::vec3 viewPos = Camera::GetFrameData().viewPos;
 
         float patchOffset = Ocean::GetBaseFFTResolution().y * scale;
 
@@ -753,136 +1137,203 @@ namespace OpenGLRenderer {
         CopyDepthBuffer(g_frameBuffers.main, g_frameBuffers.water);
 
         g_frameBuffers.water.Bind();
-        g_frameBuffers.water.SetViewport();
+        SetRenderViewport();
         g_frameBuffers.water.DrawBuffers({ "Color", "UnderwaterMask" });
         
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Displacement"));
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Normals"));
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Displacement"));
-        glActiveTexture(GL_TEXTURE3);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Normals"));
-        glActiveTexture(GL_TEXTURE4);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, g_skybox.cubemap.ID);
-        glActiveTexture(GL_TEXTURE5);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.main.GetColorAttachmentHandleByName("WorldPosition"));
+        OpenGLState::BindTexture(0, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Displacement"));
+        OpenGLState::BindTexture(1, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Normals"));
+        OpenGLState::BindTexture(2, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Displacement"));
+        OpenGLState::BindTexture(3, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Normals"));
+        OpenGLState::BindTexture(4, g_skybox.cubemap.ID);
+        OpenGLState::BindTexture(5, g_frameBuffers.main.GetDepthAttachmentHandle());
+        OpenGLState::BindTexture(6, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("InverseDisplacement"));
+        OpenGLState::BindTexture(7, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("InverseDisplacement"));
+
+        UpdateOceanClipmap(viewPos);
+        OpenGLState::BindTexture(8, g_oceanClipmapDisplacement);
+        OpenGLState::BindTexture(9, g_oceanClipmapNormals);
 
         glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
         glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
 
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
+        OpenGLState::Enable(GL_CULL_FACE);
+        OpenGLState::Enable(GL_DEPTH_TEST);
 
         // Tessellated ocean
         tesseleationTransform.position.x = -patchOffset;
         g_shaders.oceanGeometry.Use();
-        g_shaders.oceanGeometry.SetMat4("u_projectionView", projectionView);
         g_shaders.oceanGeometry.SetVec3("u_wireframeColor", GREEN);
-        g_shaders.oceanGeometry.SetMat4("u_model", tesseleationTransform.to_mat4());
         g_shaders.oceanGeometry.SetInt("u_mode", g_mode);
-        g_shaders.oceanGeometry.SetVec3("u_viewPos", viewPos);
         g_shaders.oceanGeometry.SetVec2("u_fftGridSize", Ocean::GetBaseFFTResolution());
         g_shaders.oceanGeometry.SetBool("u_wireframe", wireframe);
         g_shaders.oceanGeometry.SetFloat("u_meshSubdivisionFactor", Ocean::GetMeshSubdivisionFactor());
+        g_shaders.oceanGeometry.SetBool("u_foam", g_oceanJacobian);
+        g_shaders.oceanGeometry.SetVec2("u_clipmapCenter", glm::vec2(viewPos.x, viewPos.z));
 
-        glGenerateTextureMipmap(g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Normals"));
-        glGenerateTextureMipmap(g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Normals"));
-
-        glBindVertexArray(g_tesselationPatch.GetVAO());
+        OpenGLState::BindVertexArray(g_tesselationPatch.GetVAO());
         glPatchParameteri(GL_PATCH_VERTICES, 4);
 
-        // Surface
-        glCullFace(GL_BACK);
-        g_shaders.oceanGeometry.SetInt("u_normalMultipler", 1);
-        for (int x = min; x < max; x++) {
-            for (int z = min; z < max; z++) {
-                tesseleationTransform.position = glm::vec3(patchOffset * x, Ocean::GetOceanOriginY(), patchOffset* z);
-                if (swap) {
-                    tesseleationTransform.position += glm::vec3(offset, 0.0f, 0.0f);
+        g_timerQueries.oceanGeometry.Begin();
+
+        // Patches only differ by translation, so the scaled matrix is built once and its last column replaced per patch
+        glm::mat4 patchMatrix = tesseleationTransform.to_mat4();
+
+        // Surface and underside in one pass, the fragment shader flips the normal on back faces
+        if (singlePass) {
+            OpenGLState::Disable(GL_CULL_FACE);
+            for (int x = min; x < max; x++) {
+                for (int z = min; z < max; z++) {
+                    tesseleationTransform.position = glm::vec3(patchOffset * x, Ocean::GetOceanOriginY(), patchOffset * z);
+                    if (swap) {
+                        tesseleationTransform.position += glm::vec3(offset, 0.0f, 0.0f);
+                    }
+                    patchMatrix[3] = glm::vec4(tesseleationTransform.position, 1.0f);
+                    uint32_t drawIndex = PushDrawUniforms(patchMatrix);
+                    if (drawIndex == INVALID_DRAW_INDEX) {
+                        continue;
+                    }
+                    glDrawElementsInstancedBaseInstance(GL_PATCHES, g_tesselationPatch.GetIndexCount(), GL_UNSIGNED_INT, nullptr, 1, drawIndex);
                 }
-                g_shaders.oceanGeometry.SetMat4("u_model", tesseleationTransform.to_mat4());
-                glDrawElements(GL_PATCHES, g_tesselationPatch.GetIndexCount(), GL_UNSIGNED_INT, nullptr);
             }
+            OpenGLState::Enable(GL_CULL_FACE);
         }
-
-        // Inverted surface
-        glCullFace(GL_FRONT);
-        g_shaders.oceanGeometry.SetInt("u_normalMultipler", -1);
-        for (int x = min; x < max; x++) {
-            for (int z = min; z < max; z++) {
-                tesseleationTransform.position = glm::vec3(patchOffset * x, Ocean::GetOceanOriginY(), patchOffset * z);
-                if (swap) {
-                    tesseleationTransform.position += glm::vec3(offset, 0.0f, 0.0f);
+        // Legacy path, kept for timing comparison
+        else {
+            for (int pass = 0; pass < 2; pass++) {
+                OpenGLState::CullFace(pass == 0 ? GL_BACK : GL_FRONT);
+                for (int x = min; x < max; x++) {
+                    for (int z = min; z < max; z++) {
+                        tesseleationTransform.position = glm::vec3(patchOffset * x, Ocean::GetOceanOriginY(), patchOffset * z);
+                        if (swap) {
+                            tesseleationTransform.position += glm::vec3(offset, 0.0f, 0.0f);
+                        }
+                        patchMatrix[3] = glm::vec4(tesseleationTransform.position, 1.0f);
+                        uint32_t drawIndex = PushDrawUniforms(patchMatrix);
+                        if (drawIndex == INVALID_DRAW_INDEX) {
+                            continue;
+                        }
+                        glDrawElementsInstancedBaseInstance(GL_PATCHES, g_tesselationPatch.GetIndexCount(), GL_UNSIGNED_INT, nullptr, 1, drawIndex);
+                    }
                 }
-                g_shaders.oceanGeometry.SetMat4("u_model", tesseleationTransform.to_mat4());
-                glDrawElements(GL_PATCHES, g_tesselationPatch.GetIndexCount(), GL_UNSIGNED_INT, nullptr);
             }
         }
 
+        g_timerQueries.oceanGeometry.End();
+
         // Cleanup
         g_shaders.oceanGeometry.SetBool("u_wireframe", false);
-        glEnable(GL_DEPTH_TEST);
-        glCullFace(GL_BACK);
+        OpenGLState::Enable(GL_DEPTH_TEST);
+        OpenGLState::CullFace(GL_BACK);
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
         // Composite
-        glm::mat4 inverseProjectionView = glm::inverse(projectionView);
-        glm::vec2 resolution = glm::vec2(g_frameBuffers.main.GetWidth(), g_frameBuffers.main.GetHeight());
+        glm::mat4 inverseProjectionView = Camera::GetFrameData().inverseProjectionView;
+        glm::vec2 resolution = GetRenderSize();
+
+        OpenGLState::BindTexture(0, g_frameBuffers.water.GetColorAttachmentHandleByName("Color"));
+        OpenGLState::BindTexture(1, g_frameBuffers.hair.GetColorAttachmentHandleByName("Composite"));
+        OpenGLState::BindTexture(2, AssetManager::GetTextureByName("WaterNormals")->GetGLTexture().GetHandle());
+        OpenGLState::BindTexture(3, AssetManager::GetTextureByName("WaterDUDV")->GetGLTexture().GetHandle());
+        OpenGLState::BindTexture(4, g_frameBuffers.water.GetColorAttachmentHandleByName("UnderwaterMask"));
+        OpenGLState::BindTexture(5, g_frameBuffers.downSamplesQuarter.GetColorAttachmentHandleByName("FinalLighting"));
+
         g_shaders.oceanSurfaceComposite.Use();
         g_shaders.oceanSurfaceComposite.SetFloat("u_time", g_globalTime);
-        g_shaders.oceanSurfaceComposite.SetVec3("u_viewPos", Camera::GetViewPos());
+        g_shaders.oceanSurfaceComposite.SetVec3("u_viewPos", Camera::GetFrameData().viewPos);
         g_shaders.oceanSurfaceComposite.SetVec2("u_resolution", resolution);
         g_shaders.oceanSurfaceComposite.SetMat4("u_inverseProjectionView", inverseProjectionView);
         glBindImageTexture(0, g_frameBuffers.main.GetColorAttachmentHandleByName("Color"), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.water.GetColorAttachmentHandleByName("Color"));
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.hair.GetColorAttachmentHandleByName("Composite"));
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByName("WaterNormals")->GetGLTexture().GetHandle());
-        glActiveTexture(GL_TEXTURE3);
-        glBindTexture(GL_TEXTURE_2D, AssetManager::GetTextureByName("WaterDUDV")->GetGLTexture().GetHandle());
-        glActiveTexture(GL_TEXTURE4);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.water.GetColorAttachmentHandleByName("UnderwaterMask"));
-        glActiveTexture(GL_TEXTURE5);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.downSamplesQuarter.GetColorAttachmentHandleByName("FinalLighting"));
+        glDispatchCompute((GetRenderSize().x + 7) / 8, (GetRenderSize().y + 7) / 8, 1);
+    }
+
+    void UpdateOceanClipmap(glm::vec3 viewPos) {
+        int clipmapResolution = Ocean::GetClipmapResolution();
+
+        // Expects the band textures bound to units 0-3 as in RenderOcean
+        g_shaders.oceanClipmap.Use();
+        g_shaders.oceanClipmap.SetVec2("u_clipmapCenter", glm::vec2(viewPos.x, viewPos.z));
+        g_shaders.oceanClipmap.SetInt("u_mode", g_mode);
+        glBindImageTexture(0, g_oceanClipmapDisplacement, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+        glBindImageTexture(1, g_oceanClipmapNormals, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RG16F);
+        glDispatchCompute((clipmapResolution + 7) / 8, (clipmapResolution + 7) / 8, Ocean::GetClipmapLevelCount());
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
 
+    GLenum GetOceanDisplacementFormat() {
+        return (g_oceanTextureFormat == OceanTextureFormat::FULL_PRECISION) ? GL_RGBA32F : GL_RGBA16F;
+    }
+
+    GLenum GetOceanNormalsFormat() {
+        return (g_oceanTextureFormat == OceanTextureFormat::COMPACT) ? GL_RG8_SNORM : GL_RG16F;
+    }
+
+    void CreateOceanTextures() {
+        OpenGLFrameBuffer* fftFrameBuffers[2] = { &g_frameBuffers.fft_band0, &g_frameBuffers.fft_band1 };
+        const char* fftFrameBufferNames[2] = { "FFT", "FFT2" };
+
+        for (int i = 0; i < 2; i++) {
+            OpenGLFrameBuffer& fftFrameBuffer = *fftFrameBuffers[i];
+            if (fftFrameBuffer.GetHandle() != 0) {
+                fftFrameBuffer.CleanUp();
+            }
+            fftFrameBuffer.Create(fftFrameBufferNames[i], Ocean::GetFFTResolution(i).x, Ocean::GetFFTResolution(i).y);
+            fftFrameBuffer.CreateAttachment("Displacement", GetOceanDisplacementFormat(), GL_LINEAR, GL_LINEAR, GL_REPEAT);
+            fftFrameBuffer.CreateAttachment("Normals", GetOceanNormalsFormat(), GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, true);
+            fftFrameBuffer.CreateAttachment("InverseDisplacement", GL_RGBA16F, GL_LINEAR, GL_LINEAR, GL_REPEAT);
 
-        glDispatchCompute((g_frameBuffers.main.GetWidth() + 7) / 8, (g_frameBuffers.main.GetHeight() + 7) / 8, 1);
+            // Only the levels written by the update textures pass are sampled
+            glTextureParameteri(fftFrameBuffer.GetColorAttachmentHandleByName("Normals"), GL_TEXTURE_MAX_LEVEL, Ocean::GetNormalMipCount() - 1);
+        }
+    }
+
+    void PrintOceanTextureFootprint() {
+        const char* formatNames[] = { "FULL_PRECISION", "HALF_PRECISION", "COMPACT" };
+        size_t displacementBytes = 0;
+        size_t normalsBytes = 0;
+
+        for (int i = 0; i < 2; i++) {
+            glm::uvec2 resolution = Ocean::GetFFTResolution(i);
+            displacementBytes += resolution.x * resolution.y * OpenGLUtil::GetBytesPerTexel(GetOceanDisplacementFormat());
+            for (int level = 0; level < Ocean::GetNormalMipCount(); level++) {
+                normalsBytes += (resolution.x >> level) * (resolution.y >> level) * OpenGLUtil::GetBytesPerTexel(GetOceanNormalsFormat());
+            }
+        }
+        // Allocated size of both bands, normals including their mips. Not a measure of per frame traffic
+        std::cout << "Ocean texture memory " << formatNames[(int)g_oceanTextureFormat] << ": "
+            << "displacement " << displacementBytes / 1024 << " KB, "
+            << "normals " << normalsBytes / 1024 << " KB, "
+            << "total " << (displacementBytes + normalsBytes) / 1024 << " KB resident\n";
     }
 
     void RenderSkyBox() {
 
-        glEnable(GL_DEPTH_TEST);
+        OpenGLState::Enable(GL_DEPTH_TEST);
 
         g_frameBuffers.main.Bind();
-        g_frameBuffers.main.SetViewport();
-        g_frameBuffers.main.DrawBuffers({ "Color", "WorldPosition" });
+        SetRenderViewport();
+        g_frameBuffers.main.DrawBuffers({ "Color" });
 
         Transform skyboxTransform;
-        skyboxTransform.position = Camera::GetViewPos();
+        skyboxTransform.position = Camera::GetFrameData().viewPos;
         skyboxTransform.scale = glm::vec3(200.0f);
 
-        glm::mat4 projectionMatrix = Camera::GetProjectionMatrix();
-        glm::mat4 viewMatrix = Camera::GetViewMatrix();
+        glm::mat4 projectionMatrix = Camera::GetFrameData().projection;
+        glm::mat4 viewMatrix = Camera::GetFrameData().view;
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, g_skybox.cubemap.ID);
+        OpenGLState::BindTexture(0, g_skybox.cubemap.ID);
 
         g_shaders.skybox.Use();
         g_shaders.skybox.SetInt("environmentMap", 0);
         g_shaders.skybox.SetMat4("view", viewMatrix);
         g_shaders.skybox.SetMat4("projection", projectionMatrix);
         g_shaders.skybox.SetMat4("u_model", skyboxTransform.to_mat4());
-        g_shaders.skybox.SetVec3("u_viewPos", Camera::GetViewPos());
-        g_shaders.skybox.SetVec3("u_cameraForward", Camera::GetForward());
+        g_shaders.skybox.SetVec3("u_viewPos", Camera::GetFrameData().viewPos);
+        g_shaders.skybox.SetVec3("u_cameraForward", Camera::GetFrameData().forward);
 
-        glDepthFunc(GL_LEQUAL);
-        glBindVertexArray(g_skybox.vao);
+        OpenGLState::DepthFunc(GL_LEQUAL);
+        OpenGLState::BindVertexArray(g_skybox.vao);
         glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        glDepthFunc(GL_LESS);
+        OpenGLState::DepthFunc(GL_LESS);
         glClear(GL_DEPTH_BUFFER_BIT);
     }
 
@@ -892,18 +1343,53 @@ namespace OpenGLRenderer {
         g_shaders.underwaterTest.SetFloat("u_oceanModelMatrixScale", Ocean::GetModelMatrixScale());
         g_shaders.underwaterTest.SetFloat("u_oceanOriginY", Ocean::GetOceanOriginY());
         g_shaders.underwaterTest.SetInt("u_mode", g_mode);
-        g_shaders.underwaterTest.SetVec3("u_viewPos", Camera::GetViewPos());
+        g_shaders.underwaterTest.SetVec3("u_viewPos", Camera::GetFrameData().viewPos);
+        g_shaders.underwaterTest.SetMat4("u_inverseProjectionView", Camera::GetFrameData().inverseProjectionView);
+        g_shaders.underwaterTest.SetVec2("u_viewportSize", GetRenderSize());
 
         glBindImageTexture(0, g_frameBuffers.main.GetColorAttachmentHandleByName("Color"), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.main.GetColorAttachmentHandleByName("WorldPosition"));
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("Displacement"));
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("Displacement"));
+        OpenGLState::BindTexture(0, g_frameBuffers.main.GetDepthAttachmentHandle());
+        OpenGLState::BindTexture(1, g_frameBuffers.fft_band0.GetColorAttachmentHandleByName("InverseDisplacement"));
+        OpenGLState::BindTexture(2, g_frameBuffers.fft_band1.GetColorAttachmentHandleByName("InverseDisplacement"));
+
+        glDispatchCompute((GetRenderSize().x + 7) / 8, (GetRenderSize().y + 7) / 8, 1);
+    }
 
-        glDispatchCompute((g_frameBuffers.main.GetWidth() + 7) / 8, (g_frameBuffers.main.GetHeight() + 7) / 8, 1);
+    // Farthest depth per screen tile of the opaque scene, read back a frame or two later for CPU occlusion culling
+    void WriteOcclusionDepth() {
+        if (!Scene::OcclusionCullingEnabled()) {
+            return;
+        }
+        int writeIndex = g_occlusionDepthReadback.GetWriteIndex();
+        g_occlusionProjectionViews[writeIndex] = Camera::GetFrameData().projectionView;
+        g_occlusionWriteFrames[writeIndex] = g_frameNumber;
+
+        g_shaders.occlusionDepth.Use();
+        g_shaders.occlusionDepth.SetUvec2("u_renderSize", GetRenderSize());
+        g_shaders.occlusionDepth.SetUvec2("u_tileCount", glm::uvec2(OCCLUSION_TILES_X, OCCLUSION_TILES_Y));
+        OpenGLState::BindTexture(0, g_frameBuffers.main.GetDepthAttachmentHandle());
+        g_occlusionDepthReadback.BindWriteRange(GL_SHADER_STORAGE_BUFFER, 12);
+        glDispatchCompute((OCCLUSION_TILES_X + 7) / 8, (OCCLUSION_TILES_Y + 7) / 8, 1);
+        g_occlusionDepthReadback.EndWrite();
+    }
+
+    void ReadBackOcclusionDepth() {
+        if (!Scene::OcclusionCullingEnabled()) {
+            return;
+        }
+        int segmentIndex = 0;
+        const float* depths = (const float*)g_occlusionDepthReadback.GetLatestResult(segmentIndex);
+        // Segments left over from before culling was last switched on are ignored
+        if (!depths || g_frameNumber - g_occlusionWriteFrames[segmentIndex] > OpenGLReadbackBuffer::FRAME_COUNT) {
+            return;
+        }
+        Culling::OcclusionDepthBuffer& depthBuffer = Scene::GetOcclusionDepthBuffer();
+        depthBuffer.width = OCCLUSION_TILES_X;
+        depthBuffer.height = OCCLUSION_TILES_Y;
+        depthBuffer.projectionView = g_occlusionProjectionViews[segmentIndex];
+        depthBuffer.depths.assign(depths, depths + OCCLUSION_TILES_X * OCCLUSION_TILES_Y);
+        depthBuffer.valid = true;
     }
 
     void LoadShaders() {
@@ -916,6 +1402,7 @@ namespace OpenGLRenderer {
             
             g_shaders.hairfinalComposite.Load({ "gl_hair_final_composite.comp" }) &&
             g_shaders.hairLayerComposite.Load({ "gl_hair_layer_composite.comp" }) &&
+            g_shaders.hairOITResolve.Load({ "gl_hair_oit_resolve.comp" }) &&
             g_shaders.solidColor.Load({ "gl_solid_color.vert", "gl_solid_color.frag" }) &&
             g_shaders.skybox.Load({ "GL_skybox.vert", "GL_skybox.frag" }) &&
 
@@ -924,27 +1411,259 @@ namespace OpenGLRenderer {
             g_shaders.oceanWireframe.Load({ "GL_ocean_wireframe.vert", "GL_ocean_wireframe.frag" }) &&
             g_shaders.oceanCalculateSpectrum.Load({ "GL_ocean_calculate_spectrum.comp" }) &&
             g_shaders.oceanUpdateTextures.Load({ "GL_ocean_update_textures.comp" }) &&
+            g_shaders.oceanInverseDisplacement.Load({ "GL_ocean_inverse_displacement.comp" }) &&
+            g_shaders.oceanClipmap.Load({ "GL_ocean_clipmap.comp" }) &&
             g_shaders.underwaterTest.Load({ "GL_underwater_test.comp" }) &&
+            g_shaders.occlusionDepth.Load({ "gl_occlusion_depth.comp" }) &&
 
             g_shaders.hairDepthPeel.Load({ "gl_hair_depth_peel.vert", "gl_hair_depth_peel.frag" }) &&
             g_shaders.lighting.Load({ "gl_lighting.vert", "gl_lighting.frag" }) &&
+            g_shaders.depthPrepass.Load({ "gl_depth_prepass.vert", "gl_depth_prepass.frag" }) &&
+            g_shaders.meshletCull.Load({ "gl_meshlet_cull.comp" }) &&
             g_shaders.textBlitter.Load({ "gl_text_blitter.vert", "gl_text_blitter.frag" })) {
             std::cout << "Hotloaded shaders\n";
         }
     }
 
+    void ResizeRenderTargets(int width, int height) {
+        g_frameBuffers.main.Resize(width, height);
+        g_frameBuffers.water.Resize(width, height);
+        g_frameBuffers.hair.Resize(width, height);
+        g_frameBuffers.downSamplesQuarter.Resize(width / 4, height / 4);
+        g_frameBuffers.finalImage.Resize(width, height);
+        OpenGLState::Invalidate(); // Resizing recreates the attachments
+    }
+
+    void UpdateResolutionScale() {
+        if (Input::KeyPressed(HELL_KEY_Z)) {
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            g_dynamicResolution = !g_dynamicResolution;
+            g_resolutionScale = MAX_RESOLUTION_SCALE;
+            g_timerQueries.frame.Reset();
+            std::cout << "Dynamic resolution: " << (g_dynamicResolution ? "ON" : "OFF") << "\n";
+        }
+        if (Input::KeyPressed(HELL_KEY_P)) {
+            g_timerQueries.frame.Print("Frame GPU");
+            glm::ivec2 renderSize = GetRenderSize();
+            std::cout << "Render resolution: " << renderSize.x << " x " << renderSize.y << " (" << std::format("{:.2f}", g_resolutionScale) << ")\n";
+        }
+        float frameTime = g_timerQueries.frame.GetLastTime();
+        if (!g_dynamicResolution || frameTime <= 0.0f) {
+            return;
+        }
+        // Pixel cost goes with area, so correct the scale by the square root of the time ratio and ease towards it
+        float targetScale = g_resolutionScale * std::sqrt(TARGET_GPU_FRAME_TIME / frameTime);
+        targetScale = std::clamp(targetScale, MIN_RESOLUTION_SCALE, MAX_RESOLUTION_SCALE);
+        g_resolutionScale += (targetScale - g_resolutionScale) * 0.1f;
+        // The ease never quite arrives, snap so full resolution renders at the exact target size again
+        if (MAX_RESOLUTION_SCALE - g_resolutionScale < 0.005f) {
+            g_resolutionScale = MAX_RESOLUTION_SCALE;
+        }
+    }
+
+    glm::ivec2 GetRenderSize() {
+        // Exact target size when unscaled, the compute passes bounds check partial 8x8 groups
+        if (g_resolutionScale >= MAX_RESOLUTION_SCALE) {
+            return glm::ivec2(g_frameBuffers.main.GetWidth(), g_frameBuffers.main.GetHeight());
+        }
+        // Scaled sizes are rounded to multiples of 8 so small scale changes don't shift the viewport every frame
+        int width = (int(g_frameBuffers.main.GetWidth() * g_resolutionScale) / 8) * 8;
+        int height = (int(g_frameBuffers.main.GetHeight() * g_resolutionScale) / 8) * 8;
+        width = std::clamp(width, 8, (int)g_frameBuffers.main.GetWidth());
+        height = std::clamp(height, 8, (int)g_frameBuffers.main.GetHeight());
+        return glm::ivec2(width, height);
+    }
+
+    void SetRenderViewport() {
+        glm::ivec2 renderSize = GetRenderSize();
+        glViewport(0, 0, renderSize.x, renderSize.y);
+    }
+
+    void UpdateFrameUniforms() {
+        g_frameUniformsRing.BeginFrame();
+        g_drawUniformsRing.BeginFrame();
+        g_indirectCommandsRing.BeginFrame();
+        g_meshletJobsRing.BeginFrame();
+        g_drawUniformsCount = 0;
+        g_drawUniformsOverflowReported = false;
+        g_indirectCommandCount = 0;
+        g_meshletJobCount = 0;
+
+        FrameUniforms* frameUniforms = (FrameUniforms*)g_frameUniformsRing.GetSegmentPointer();
+        if (!frameUniforms) {
+            return;
+        }
+        glm::ivec2 renderSize = GetRenderSize();
+        frameUniforms->projection = Camera::GetFrameData().projection;
+        frameUniforms->view = Camera::GetFrameData().view;
+        frameUniforms->projectionView = Camera::GetFrameData().projectionView;
+        frameUniforms->inverseProjectionView = Camera::GetFrameData().inverseProjectionView;
+        frameUniforms->viewPos = glm::vec4(Camera::GetFrameData().viewPos, g_globalTime);
+        frameUniforms->viewportSize = glm::vec4(renderSize.x, renderSize.y, g_frameBuffers.main.GetWidth(), g_frameBuffers.main.GetHeight());
+
+        g_frameUniformsRing.BindRange(GL_UNIFORM_BUFFER, 0);
+        g_drawUniformsRing.BindRange(GL_SHADER_STORAGE_BUFFER, 10);
+    }
+
+    // All of count or nothing, so a list that overflows never leaves later draws reading unwritten slots
+    DrawUniforms* ReserveDrawUniforms(uint32_t count, uint32_t& baseDrawIndex) {
+        DrawUniforms* drawUniforms = (DrawUniforms*)g_drawUniformsRing.GetSegmentPointer();
+        if (!drawUniforms || g_drawUniformsCount + count > MAX_DRAWS_PER_FRAME) {
+            if (!g_drawUniformsOverflowReported) {
+                std::cout << "ReserveDrawUniforms() failed because MAX_DRAWS_PER_FRAME (" << MAX_DRAWS_PER_FRAME << ") was exceeded, draws are being skipped\n";
+                g_drawUniformsOverflowReported = true;
+            }
+            baseDrawIndex = INVALID_DRAW_INDEX;
+            return nullptr;
+        }
+        baseDrawIndex = g_drawUniformsCount;
+        g_drawUniformsCount += count;
+        return drawUniforms + baseDrawIndex;
+    }
+
+    // Built locally then copied, the mapped memory is write combined
+    DrawUniforms BuildDrawUniforms(const glm::mat4& modelMatrix) {
+        DrawUniforms draw;
+        draw.model = modelMatrix;
+        draw.normalMatrix = glm::transpose(glm::inverse(modelMatrix));
+        draw.materialIndices = glm::uvec4(0);
+        draw.positionOffset = glm::vec4(0.0f);
+        draw.positionScale = glm::vec4(1.0f);
+        return draw;
+    }
+
+    DrawUniforms BuildDrawUniforms(const RenderItem& renderItem) {
+        DrawUniforms draw = BuildDrawUniforms(renderItem.modelMatrix);
+        draw.materialIndices = glm::uvec4(renderItem.baseColorTextureIndex, renderItem.normalTextureIndex, renderItem.rmaTextureIndex, 0);
+        OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(renderItem.meshIndex);
+        if (mesh) {
+            draw.positionOffset = glm::vec4(mesh->GetPositionOffset(), 0.0f);
+            draw.positionScale = glm::vec4(mesh->GetPositionScale(), 0.0f);
+        }
+        return draw;
+    }
+
+    uint32_t PushDrawUniforms(const glm::mat4& modelMatrix) {
+        uint32_t drawIndex = INVALID_DRAW_INDEX;
+        DrawUniforms* drawUniforms = ReserveDrawUniforms(1, drawIndex);
+        if (drawUniforms) {
+            DrawUniforms draw = BuildDrawUniforms(modelMatrix);
+            memcpy(drawUniforms, &draw, sizeof(DrawUniforms));
+        }
+        return drawIndex;
+    }
+
+    uint32_t PushDrawUniforms(const RenderItem& renderItem) {
+        uint32_t drawIndex = INVALID_DRAW_INDEX;
+        DrawUniforms* drawUniforms = ReserveDrawUniforms(1, drawIndex);
+        if (drawUniforms) {
+            DrawUniforms draw = BuildDrawUniforms(renderItem);
+            memcpy(drawUniforms, &draw, sizeof(DrawUniforms));
+        }
+        return drawIndex;
+    }
+
+    // Base index of the list, item i is at base + i
+    uint32_t PushDrawUniforms(const std::vector<RenderItem>& renderItems) {
+        uint32_t baseDrawIndex = INVALID_DRAW_INDEX;
+        DrawUniforms* drawUniforms = ReserveDrawUniforms((uint32_t)renderItems.size(), baseDrawIndex);
+        if (drawUniforms) {
+            for (size_t i = 0; i < renderItems.size(); i++) {
+                DrawUniforms draw = BuildDrawUniforms(renderItems[i]);
+                memcpy(&drawUniforms[i], &draw, sizeof(DrawUniforms));
+            }
+        }
+        return baseDrawIndex;
+    }
+
+    void BenchmarkUniformUpload() {
+        // CPU cost of per draw glUniform calls, by name and by cached handle, versus writes into the mapped ring, over every scene render item
+        std::vector<RenderItem> renderItems = Scene::GetRenderItems();
+        renderItems.insert(renderItems.end(), Scene::GetRenderItemsBlended().begin(), Scene::GetRenderItemsBlended().end());
+        renderItems.insert(renderItems.end(), Scene::GetRenderItemsHairTopLayer().begin(), Scene::GetRenderItemsHairTopLayer().end());
+        renderItems.insert(renderItems.end(), Scene::GetRenderItemsHairBottomLayer().begin(), Scene::GetRenderItemsHairBottomLayer().end());
+        const int iterations = 100;
+        std::string suffix = " (" + std::to_string(renderItems.size()) + " draws x " + std::to_string(iterations) + ")";
+
+        {
+            Timer timer("Uniforms glUniform" + suffix);
+            for (int i = 0; i < iterations; i++) {
+                g_shaders.solidColor.Use();
+                g_shaders.solidColor.SetMat4("projection", Camera::GetFrameData().projection);
+                g_shaders.solidColor.SetMat4("view", Camera::GetFrameData().view);
+                for (RenderItem& renderItem : renderItems) {
+                    g_shaders.solidColor.SetMat4("model", renderItem.modelMatrix);
+                }
+            }
+        }
+        {
+            static UniformHandle<glm::mat4> modelHandle = g_shaders.solidColor.GetUniformHandle<glm::mat4>("model");
+            Timer timer("Uniforms glUniform cached handle" + suffix);
+            for (int i = 0; i < iterations; i++) {
+                g_shaders.solidColor.Use();
+                g_shaders.solidColor.SetMat4("projection", Camera::GetFrameData().projection);
+                g_shaders.solidColor.SetMat4("view", Camera::GetFrameData().view);
+                for (RenderItem& renderItem : renderItems) {
+                    g_shaders.solidColor.Set(modelHandle, renderItem.modelMatrix);
+                }
+            }
+        }
+        {
+            Timer timer("Uniforms ring buffer" + suffix);
+            for (int i = 0; i < iterations; i++) {
+                g_drawUniformsCount = 0;
+                for (RenderItem& renderItem : renderItems) {
+                    PushDrawUniforms(renderItem);
+                }
+            }
+        }
+        g_drawUniformsCount = 0;
+    }
+
+    void UpdateBindlessTextureHandles() {
+        if (Input::KeyPressed(HELL_KEY_F2) && g_bindlessTexturesSupported) {
+            Audio::PlayAudio("UI_Select.wav", 1.0f);
+            g_bindlessTextures = !g_bindlessTextures;
+            std::cout << "Bindless textures: " << (g_bindlessTextures ? "ON" : "OFF") << "\n";
+        }
+        if (!g_bindlessTextures) {
+            return;
+        }
+
+        // A handle freezes its texture, so only textures that have finished baking are made resident
+        bool dirty = g_textureHandles.size() != AssetManager::GetTextureCount();
+        g_textureHandles.resize(AssetManager::GetTextureCount(), 0);
+        for (int i = 0; i < g_textureHandles.size(); i++) {
+            Texture* texture = AssetManager::GetTextureByIndex(i);
+            if (g_textureHandles[i] == 0 && texture && texture->BakeComplete()) {
+                texture->GetGLTexture().MakeBindlessTextureResident();
+                g_textureHandles[i] = texture->GetGLTexture().GetBindlessID();
+                dirty = true;
+            }
+        }
+        if (dirty) {
+            g_textureHandlesSSBO.Update(g_textureHandles.size() * sizeof(GLuint64), g_textureHandles.data());
+        }
+        g_textureHandlesSSBO.Bind(11);
+    }
+
     void BlitFrameBuffer(OpenGLFrameBuffer* srcFrameBuffer, OpenGLFrameBuffer* dstFrameBuffer, const char* srcName, const char* dstName, GLbitfield mask, GLenum filter) {
+        glm::ivec2 srcSize = glm::ivec2(srcFrameBuffer->GetWidth(), srcFrameBuffer->GetHeight());
+        BlitFrameBuffer(srcFrameBuffer, dstFrameBuffer, srcName, dstName, srcSize, mask, filter);
+    }
+
+    void BlitFrameBuffer(OpenGLFrameBuffer* srcFrameBuffer, OpenGLFrameBuffer* dstFrameBuffer, const char* srcName, const char* dstName, glm::ivec2 srcSize, GLbitfield mask, GLenum filter) {
         GLint srcAttachmentSlot = srcFrameBuffer->GetColorAttachmentSlotByName(srcName);
         GLint dstAttachmentSlot = dstFrameBuffer->GetColorAttachmentSlotByName(dstName);
         if (srcAttachmentSlot != GL_INVALID_VALUE && dstAttachmentSlot != GL_INVALID_VALUE) {
-            glBindFramebuffer(GL_READ_FRAMEBUFFER, srcFrameBuffer->GetHandle());
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dstFrameBuffer->GetHandle());
+            OpenGLState::BindFramebuffer(GL_READ_FRAMEBUFFER, srcFrameBuffer->GetHandle());
+            OpenGLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, dstFrameBuffer->GetHandle());
             glReadBuffer(srcAttachmentSlot);
             glDrawBuffer(dstAttachmentSlot);
             float srcRectx0 = 0;
             float srcRecty0 = 0;
-            float srcRectx1 = srcFrameBuffer->GetWidth();
-            float srcRecty1 = srcFrameBuffer->GetHeight();
+            float srcRectx1 = srcSize.x;
+            float srcRecty1 = srcSize.y;
             float dstRecty0 = 0;
             float dstRectx0 = 0;
             float dstRectx1 = dstFrameBuffer->GetWidth();
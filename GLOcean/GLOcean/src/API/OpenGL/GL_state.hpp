@@ -0,0 +1,190 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <format>
+#include <string>
+
+// Shadows the GL state the renderer touches most and drops calls that would not change it.
+// Code outside this layer that binds state directly must be followed by Invalidate().
+namespace OpenGLState {
+
+    constexpr int MAX_TEXTURE_UNITS = 32;
+    constexpr GLuint UNKNOWN = 0xFFFFFFFF;
+
+    struct Counters {
+        uint32_t programBinds = 0;
+        uint32_t textureBinds = 0;
+        uint32_t vertexArrayBinds = 0;
+        uint32_t framebufferBinds = 0;
+        uint32_t stateChanges = 0;
+        uint32_t redundantCalls = 0;
+    };
+
+    struct State {
+        GLuint program = UNKNOWN;
+        GLuint vertexArray = UNKNOWN;
+        GLuint readFramebuffer = UNKNOWN;
+        GLuint drawFramebuffer = UNKNOWN;
+        GLuint textures[MAX_TEXTURE_UNITS];
+        int depthTest = -1;
+        int cullFace = -1;
+        int blend = -1;
+        GLenum depthFunc = UNKNOWN;
+        int depthMask = -1;
+        GLenum cullFaceMode = UNKNOWN;
+        GLenum blendSrc = UNKNOWN;
+        GLenum blendDst = UNKNOWN;
+    };
+
+    inline State g_state;
+    inline Counters g_counters;
+    inline Counters g_lastFrameCounters;
+
+    // Forget everything, the next call of each kind always reaches the driver
+    inline void Invalidate() {
+        g_state = State();
+        for (GLuint& texture : g_state.textures) {
+            texture = UNKNOWN;
+        }
+    }
+
+    inline void BeginFrame() {
+        g_lastFrameCounters = g_counters;
+        g_counters = Counters();
+        Invalidate();
+    }
+
+    inline const Counters& GetLastFrameCounters() {
+        return g_lastFrameCounters;
+    }
+
+    inline std::string LastFrameCountersToString() {
+        const Counters& c = g_lastFrameCounters;
+        return std::format("GL binds: program {} texture {} vao {} fbo {} state {} skipped {}", c.programBinds, c.textureBinds, c.vertexArrayBinds, c.framebufferBinds, c.stateChanges, c.redundantCalls);
+    }
+
+    inline void UseProgram(GLuint program) {
+        if (g_state.program == program) {
+            g_counters.redundantCalls++;
+            return;
+        }
+        g_state.program = program;
+        g_counters.programBinds++;
+        glUseProgram(program);
+    }
+
+    inline void BindVertexArray(GLuint vertexArray) {
+        if (g_state.vertexArray == vertexArray) {
+            g_counters.redundantCalls++;
+            return;
+        }
+        g_state.vertexArray = vertexArray;
+        g_counters.vertexArrayBinds++;
+        glBindVertexArray(vertexArray);
+    }
+
+    inline void BindFramebuffer(GLenum target, GLuint framebuffer) {
+        bool read = (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER);
+        bool draw = (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER);
+        if ((!read || g_state.readFramebuffer == framebuffer) && (!draw || g_state.drawFramebuffer == framebuffer)) {
+            g_counters.redundantCalls++;
+            return;
+        }
+        if (read) g_state.readFramebuffer = framebuffer;
+        if (draw) g_state.drawFramebuffer = framebuffer;
+        g_counters.framebufferBinds++;
+        glBindFramebuffer(target, framebuffer);
+    }
+
+    // DSA bind, so the active texture unit is never touched
+    inline void BindTexture(GLuint unit, GLuint texture) {
+        if (unit < MAX_TEXTURE_UNITS) {
+            if (g_state.textures[unit] == texture) {
+                g_counters.redundantCalls++;
+                return;
+            }
+            g_state.textures[unit] = texture;
+        }
+        g_counters.textureBinds++;
+        glBindTextureUnit(unit, texture);
+    }
+
+    inline int* GetCapabilityState(GLenum capability) {
+        switch (capability) {
+        case GL_DEPTH_TEST: return &g_state.depthTest;
+        case GL_CULL_FACE:  return &g_state.cullFace;
+        case GL_BLEND:      return &g_state.blend;
+        default:            return nullptr;
+        }
+    }
+
+    inline void SetCapability(GLenum capability, bool enabled) {
+        int* state = GetCapabilityState(capability);
+        if (state) {
+            if (*state == (int)enabled) {
+                g_counters.redundantCalls++;
+                return;
+            }
+            *state = (int)enabled;
+        }
+        g_counters.stateChanges++;
+        enabled ? glEnable(capability) : glDisable(capability);
+    }
+
+    inline void Enable(GLenum capability) {
+        SetCapability(capability, true);
+    }
+
+    inline void Disable(GLenum capability) {
+        SetCapability(capability, false);
+    }
+
+    inline void DepthFunc(GLenum func) {
+        if (g_state.depthFunc == func) {
+            g_counters.redundantCalls++;
+            return;
+        }
+        g_state.depthFunc = func;
+        g_counters.stateChanges++;
+        glDepthFunc(func);
+    }
+
+    inline void DepthMask(GLboolean mask) {
+        if (g_state.depthMask == (int)mask) {
+            g_counters.redundantCalls++;
+            return;
+        }
+        g_state.depthMask = (int)mask;
+        g_counters.stateChanges++;
+        glDepthMask(mask);
+    }
+
+    inline void CullFace(GLenum mode) {
+        if (g_state.cullFaceMode == mode) {
+            g_counters.redundantCalls++;
+            return;
+        }
+        g_state.cullFaceMode = mode;
+        g_counters.stateChanges++;
+        glCullFace(mode);
+    }
+
+    inline void BlendFunc(GLenum src, GLenum dst) {
+        if (g_state.blendSrc == src && g_state.blendDst == dst) {
+            g_counters.redundantCalls++;
+            return;
+        }
+        g_state.blendSrc = src;
+        g_state.blendDst = dst;
+        g_counters.stateChanges++;
+        glBlendFunc(src, dst);
+    }
+
+    // Per draw buffer blending leaves the global blend func unknown
+    inline void BlendFunci(GLuint buffer, GLenum src, GLenum dst) {
+        g_state.blendSrc = UNKNOWN;
+        g_state.blendDst = UNKNOWN;
+        g_counters.stateChanges++;
+        glBlendFunci(buffer, src, dst);
+    }
+}
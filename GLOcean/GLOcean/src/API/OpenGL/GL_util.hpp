@@ -454,6 +454,31 @@ namespace OpenGLUtil {
         return blocksWide * blocksHigh * blockSize;
     }
 
+    inline int GetBytesPerTexel(GLenum internalFormat) {
+        switch (internalFormat) {
+        case GL_R8:
+        case GL_R8_SNORM:
+            return 1;
+        case GL_RG8:
+        case GL_RG8_SNORM:
+        case GL_R16F:
+            return 2;
+        case GL_RGBA8:
+        case GL_RGBA8_SNORM:
+        case GL_RG16F:
+        case GL_R32F:
+            return 4;
+        case GL_RGBA16F:
+        case GL_RG32F:
+            return 8;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            std::cout << "OpenGLUtil::GetBytesPerTexel() failed: unsupported internal format\n";
+            return 0;
+        }
+    }
+
     inline GLint TextureWrapModeToGLEnum(TextureWrapMode wrapMode) {
         switch (wrapMode) {
         case TextureWrapMode::REPEAT:
@@ -1,17 +1,32 @@
 #pragma once
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
+#include "../GL_state.hpp"
 #include "HellTypes.h"
 
 struct OpenGLDetachedMesh {
 
+    struct Lod {
+        int baseIndex = 0;
+        int indexCount = 0;
+        float error = 0.0f;
+    };
+
 private:
     unsigned int VBO = 0;
     unsigned int VAO = 0;
     unsigned int EBO = 0;
     std::string m_name;
+    int m_baseVertex = -1;
+    int m_baseIndex = -1;
+    std::vector<Lod> m_lods; // LOD 0 is the full index list
+    int m_meshletOffset = 0;
+    int m_meshletCount = 0;
+    glm::vec3 m_positionOffset = glm::vec3(0.0f);
+    glm::vec3 m_positionScale = glm::vec3(1.0f);
 
 public:
     std::vector<Vertex> vertices;
@@ -36,6 +51,62 @@ public:
     int GetVAO() {
         return VAO;
     }
+    int GetBaseVertex() {
+        return m_baseVertex;
+    }
+    int GetBaseIndex() {
+        return m_baseIndex;
+    }
+    bool IsInSharedBuffer() {
+        return m_baseVertex != -1;
+    }
+    // Static meshes live in the shared mesh buffer rather than owning a VAO
+    void SetSharedBufferLocation(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, int baseVertex, int baseIndex) {
+        this->vertices = vertices;
+        this->indices = indices;
+        m_baseVertex = baseVertex;
+        m_baseIndex = baseIndex;
+        m_lods.clear();
+        m_lods.push_back({ baseIndex, (int)indices.size(), 0.0f });
+    }
+    void AddLod(int baseIndex, int indexCount, float error) {
+        m_lods.push_back({ baseIndex, indexCount, error });
+    }
+    int GetLodCount() {
+        return std::max((int)m_lods.size(), 1);
+    }
+    int GetLodBaseIndex(int lodIndex) {
+        return m_lods.empty() ? m_baseIndex : m_lods[std::clamp(lodIndex, 0, (int)m_lods.size() - 1)].baseIndex;
+    }
+    int GetLodIndexCount(int lodIndex) {
+        return m_lods.empty() ? GetIndexCount() : m_lods[std::clamp(lodIndex, 0, (int)m_lods.size() - 1)].indexCount;
+    }
+    void SetMeshlets(int meshletOffset, int meshletCount) {
+        m_meshletOffset = meshletOffset;
+        m_meshletCount = meshletCount;
+    }
+    // First meshlet in the backend's meshlet buffer, meshlets only cover LOD 0
+    int GetMeshletOffset() {
+        return m_meshletOffset;
+    }
+    int GetMeshletCount() {
+        return m_meshletCount;
+    }
+    // Positions in the shared buffer are unorm, model space is offset + position * scale
+    void SetQuantization(const glm::vec3& positionOffset, const glm::vec3& positionScale) {
+        m_positionOffset = positionOffset;
+        m_positionScale = positionScale;
+    }
+    const glm::vec3& GetPositionOffset() {
+        return m_positionOffset;
+    }
+    const glm::vec3& GetPositionScale() {
+        return m_positionScale;
+    }
+    // Geometric error of the LOD in model units, 0 for the full mesh
+    float GetLodError(int lodIndex) {
+        return m_lods.empty() ? 0.0f : m_lods[std::clamp(lodIndex, 0, (int)m_lods.size() - 1)].error;
+    }
     void UpdateVertexBuffer(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
         this->indices = indices;
         this->vertices = vertices;
@@ -56,7 +127,7 @@ public:
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
         glGenBuffers(1, &EBO);
-        glBindVertexArray(VAO);
+        OpenGLState::BindVertexArray(VAO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
@@ -69,7 +140,7 @@ public:
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
         glEnableVertexAttribArray(3);
         glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-        glBindVertexArray(0);
+        OpenGLState::BindVertexArray(0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <glad/glad.h>
+#include "../GL_state.hpp"
 #include "HellTypes.h"
 
 struct OpenGLFontMesh {
@@ -25,13 +26,13 @@ public:
             Create();
             m_vertexBufferSize = vertexBufferSize;
             m_indexBufferSize = indexBufferSize;
-            glBindVertexArray(m_vao);
+            OpenGLState::BindVertexArray(m_vao);
             glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
             glBufferData(GL_ARRAY_BUFFER, vertexBufferSize, nullptr, GL_DYNAMIC_DRAW);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBufferSize, nullptr, GL_DYNAMIC_DRAW);
         }
-        glBindVertexArray(m_vao);
+        OpenGLState::BindVertexArray(m_vao);
         glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
         glBufferSubData(GL_ARRAY_BUFFER, 0, vertexBufferSize, vertices.data());
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
@@ -42,7 +43,7 @@ public:
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(FontVertex), (void*)offsetof(FontVertex, uv));
         glEnableVertexAttribArray(2);
         glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(FontVertex), (void*)offsetof(FontVertex, color));
-        glBindVertexArray(0);
+        OpenGLState::BindVertexArray(0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
@@ -1,4 +1,5 @@
 #include "GL_frameBuffer.h"
+#include "../GL_state.hpp"
 
 GLenum GLInternalFormatToGLType(GLenum internalFormat) {
     switch (internalFormat) {
@@ -29,7 +30,15 @@ GLenum GLInternalFormatToGLType(GLenum internalFormat) {
             // Special packed integer format
         case GL_RGB10_A2UI: return GL_UNSIGNED_INT_2_10_10_10_REV;
 
-            // Normalized unsigned formats (non-integer)
+            // Normalized signed formats (non-integer)
+        case GL_R8_SNORM:    return GL_BYTE;
+        case GL_RG8_SNORM:   return GL_BYTE;
+        case GL_RGBA8_SNORM: return GL_BYTE;
+        case GL_R16_SNORM:   return GL_SHORT;
+        case GL_RG16_SNORM:  return GL_SHORT;
+        case GL_RGBA16_SNORM: return GL_SHORT;
+
+        // Normalized unsigned formats (non-integer)
         case GL_R8:        return GL_UNSIGNED_BYTE;
         case GL_RG8:       return GL_UNSIGNED_BYTE;
         case GL_RGBA8:     return GL_UNSIGNED_BYTE;
@@ -149,7 +158,7 @@ GLenum GLInternalFormatToGLFormat(GLenum internalFormat) {
 }
 
 void OpenGLFrameBuffer::Bind() {
-    glBindFramebuffer(GL_FRAMEBUFFER, m_handle);
+    OpenGLState::BindFramebuffer(GL_FRAMEBUFFER, m_handle);
 }
 
 void OpenGLFrameBuffer::SetViewport() {
@@ -172,6 +181,13 @@ void OpenGLFrameBuffer::Create(const char* name, int width, int height) {
 }
 
 void OpenGLFrameBuffer::CleanUp() {
+    for (ColorAttachment& colorAttachment : m_colorAttachments) {
+        glDeleteTextures(1, &colorAttachment.handle);
+    }
+    if (m_depthAttachment.handle != 0) {
+        glDeleteTextures(1, &m_depthAttachment.handle);
+        m_depthAttachment.handle = 0;
+    }
     m_colorAttachments.clear();
     glDeleteFramebuffers(1, &m_handle);
     m_handle = 0;
@@ -363,14 +379,6 @@ void OpenGLFrameBuffer::Resize(int width, int height) {
         glTextureParameteri(colorAttachment.handle, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTextureParameteri(colorAttachment.handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTextureParameteri(colorAttachment.handle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-
-        glTextureParameteri(m_depthAttachment.handle, GL_TEXTURE_WRAP_S, GL_LINEAR);
-        glTextureParameteri(m_depthAttachment.handle, GL_TEXTURE_WRAP_T, GL_LINEAR);
-        glTextureParameteri(colorAttachment.handle, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTextureParameteri(colorAttachment.handle, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-
         glNamedFramebufferTexture(m_handle, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i), colorAttachment.handle, 0);
         std::string debugLabel = "Texture (FBO: " + std::string(m_name) + " Tex: " + std::string(colorAttachment.name) + ")";
         glObjectLabel(GL_TEXTURE, colorAttachment.handle, static_cast<GLsizei>(debugLabel.length()), debugLabel.c_str());
@@ -428,8 +436,8 @@ GLenum OpenGLFrameBuffer::GetColorAttachmentSlotByName(const char* name) const {
 }
 
 void OpenGLFrameBuffer::BlitToDefaultFrameBuffer(const char* srcName, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter) {
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, GetHandle());
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    OpenGLState::BindFramebuffer(GL_READ_FRAMEBUFFER, GetHandle());
+    OpenGLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     glReadBuffer(GetColorAttachmentSlotByName(srcName));
     glDrawBuffer(GL_BACK);
     glBlitFramebuffer(0, 0, GetWidth(), GetHeight(), dstX0, dstY0, dstX1, dstY1, mask, filter);
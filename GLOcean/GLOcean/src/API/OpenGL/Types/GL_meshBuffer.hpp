@@ -0,0 +1,134 @@
+#pragma once
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <iostream>
+#include "HellTypes.h"
+
+// Matches Meshlet in gl_meshlet_cull.comp, firstIndex is absolute within the shared index buffer
+struct OpenGLMeshlet {
+    glm::vec4 centerRadius;
+    glm::vec4 coneAxisCutoff;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t padding[2];
+};
+
+// One vertex and one index buffer shared by every static mesh, drawn through a single VAO.
+// Meshes are addressed by base vertex and first index, which is what indirect draw commands take.
+// Vertices are stored as CompactVertex, shaders rebuild positions from the per draw AABB offset and scale.
+struct OpenGLMeshBuffer {
+public:
+    void AddMesh(const std::vector<CompactVertex>& vertices, const std::vector<uint32_t>& indices, int& baseVertex, int& baseIndex) {
+        if (m_vao == 0) {
+            CreateVAO();
+        }
+        Reserve(m_vbo, m_vboCapacity, (m_vertexCount + vertices.size()) * sizeof(CompactVertex));
+        Reserve(m_ebo, m_eboCapacity, (m_indexCount + indices.size()) * sizeof(uint32_t));
+        glVertexArrayVertexBuffer(m_vao, 0, m_vbo, 0, sizeof(CompactVertex));
+        glVertexArrayElementBuffer(m_vao, m_ebo);
+
+        baseVertex = (int)m_vertexCount;
+        baseIndex = (int)m_indexCount;
+        glNamedBufferSubData(m_vbo, m_vertexCount * sizeof(CompactVertex), vertices.size() * sizeof(CompactVertex), vertices.data());
+        glNamedBufferSubData(m_ebo, m_indexCount * sizeof(uint32_t), indices.size() * sizeof(uint32_t), indices.data());
+        m_vertexCount += vertices.size();
+        m_indexCount += indices.size();
+    }
+
+    // Extra index list over vertices that are already in the buffer, returns its first index
+    int AddIndices(const std::vector<uint32_t>& indices) {
+        Reserve(m_ebo, m_eboCapacity, (m_indexCount + indices.size()) * sizeof(uint32_t));
+        glVertexArrayElementBuffer(m_vao, m_ebo);
+        int baseIndex = (int)m_indexCount;
+        glNamedBufferSubData(m_ebo, m_indexCount * sizeof(uint32_t), indices.size() * sizeof(uint32_t), indices.data());
+        m_indexCount += indices.size();
+        return baseIndex;
+    }
+
+    // Meshlets are kept in their own buffer for the culling shader, returns the first one's index
+    int AddMeshlets(const std::vector<OpenGLMeshlet>& meshlets) {
+        Reserve(m_meshletBuffer, m_meshletCapacity, (m_meshletCount + meshlets.size()) * sizeof(OpenGLMeshlet));
+        int meshletOffset = (int)m_meshletCount;
+        glNamedBufferSubData(m_meshletBuffer, m_meshletCount * sizeof(OpenGLMeshlet), meshlets.size() * sizeof(OpenGLMeshlet), meshlets.data());
+        m_meshletCount += meshlets.size();
+        return meshletOffset;
+    }
+
+    GLuint GetMeshletBuffer() const {
+        return m_meshletBuffer;
+    }
+
+    GLuint GetVAO() const {
+        return m_vao;
+    }
+
+    size_t GetVertexCount() const {
+        return m_vertexCount;
+    }
+
+    size_t GetIndexCount() const {
+        return m_indexCount;
+    }
+
+    void CleanUp() {
+        if (m_vao != 0) {
+            glDeleteVertexArrays(1, &m_vao);
+            glDeleteBuffers(1, &m_vbo);
+            glDeleteBuffers(1, &m_ebo);
+        }
+        if (m_meshletBuffer != 0) {
+            glDeleteBuffers(1, &m_meshletBuffer);
+        }
+        m_vao = m_vbo = m_ebo = m_meshletBuffer = 0;
+        m_vertexCount = m_indexCount = m_meshletCount = 0;
+        m_vboCapacity = m_eboCapacity = m_meshletCapacity = 0;
+    }
+
+private:
+    void CreateVAO() {
+        glCreateVertexArrays(1, &m_vao);
+        glEnableVertexArrayAttrib(m_vao, 0);
+        glEnableVertexArrayAttrib(m_vao, 1);
+        glEnableVertexArrayAttrib(m_vao, 2);
+        glEnableVertexArrayAttrib(m_vao, 3);
+        // Normal and tangent hold octahedral x and y in the first two 10 bit fields, see vertex_format.glsl
+        glVertexArrayAttribFormat(m_vao, 0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(CompactVertex, position));
+        glVertexArrayAttribFormat(m_vao, 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(CompactVertex, normal));
+        glVertexArrayAttribFormat(m_vao, 2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(CompactVertex, uv));
+        glVertexArrayAttribFormat(m_vao, 3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(CompactVertex, tangent));
+        glVertexArrayAttribBinding(m_vao, 0, 0);
+        glVertexArrayAttribBinding(m_vao, 1, 0);
+        glVertexArrayAttribBinding(m_vao, 2, 0);
+        glVertexArrayAttribBinding(m_vao, 3, 0);
+    }
+
+    // Grows by doubling, existing contents are copied across on the GPU
+    void Reserve(GLuint& buffer, size_t& capacity, size_t requiredSize) {
+        if (requiredSize <= capacity) {
+            return;
+        }
+        size_t newCapacity = std::max(requiredSize, capacity * 2);
+        GLuint newBuffer = 0;
+        glCreateBuffers(1, &newBuffer);
+        glNamedBufferStorage(newBuffer, (GLsizeiptr)newCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+        if (buffer != 0) {
+            glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, (GLsizeiptr)capacity);
+            glDeleteBuffers(1, &buffer);
+        }
+        buffer = newBuffer;
+        capacity = newCapacity;
+    }
+
+    GLuint m_vao = 0;
+    GLuint m_vbo = 0;
+    GLuint m_ebo = 0;
+    size_t m_vertexCount = 0;
+    size_t m_indexCount = 0;
+    size_t m_vboCapacity = 0;
+    size_t m_eboCapacity = 0;
+    GLuint m_meshletBuffer = 0;
+    size_t m_meshletCount = 0;
+    size_t m_meshletCapacity = 0;
+};
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <vector>
 #include <glad/glad.h>
+#include "../GL_state.hpp"
 #include <glm/glm.hpp>
 
 void OpenGLMeshPatch::CleanUp() {
@@ -97,7 +98,7 @@ void OpenGLMeshPatch::CreateBuffers() {
     m_indexCount = 2 * n * (m - 1) + 2 * (m - 2);
 
     glGenVertexArrays(1, &m_VAO);
-    glBindVertexArray(m_VAO);
+    OpenGLState::BindVertexArray(m_VAO);
 
     glGenBuffers(1, &m_VBO);
     glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
@@ -116,7 +117,7 @@ void OpenGLMeshPatch::CreateBuffers() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normalOffsetPtr);
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
+    OpenGLState::BindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
@@ -159,7 +160,7 @@ void OpenGLMeshPatch::CreateBuffers2() {
     m_indexCount = indices.size();
 
     glGenVertexArrays(1, &m_VAO);
-    glBindVertexArray(m_VAO);
+    OpenGLState::BindVertexArray(m_VAO);
 
     glGenBuffers(1, &m_VBO);
     glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
@@ -178,7 +179,7 @@ void OpenGLMeshPatch::CreateBuffers2() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normalOffsetPtr);
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
+    OpenGLState::BindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
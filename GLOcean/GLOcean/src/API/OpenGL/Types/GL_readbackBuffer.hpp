@@ -0,0 +1,101 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <iostream>
+
+// Persistently mapped buffer the GPU writes one segment of per frame and the CPU reads back a few frames later.
+// Reads never block, GetLatestResult() only returns segments whose fence has already signalled.
+struct OpenGLReadbackBuffer {
+public:
+    static constexpr int FRAME_COUNT = 3;
+
+    void PreAllocate(size_t segmentSize) {
+        CleanUp();
+
+        GLint storageAlignment = 256;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+        m_segmentSize = (segmentSize + storageAlignment - 1) / storageAlignment * storageAlignment;
+
+        GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &m_handle);
+        glNamedBufferStorage(m_handle, (GLsizeiptr)(m_segmentSize * FRAME_COUNT), nullptr, flags);
+        m_persistentBuffer = (GLubyte*)glMapNamedBufferRange(m_handle, 0, (GLsizeiptr)(m_segmentSize * FRAME_COUNT), flags);
+        if (!m_persistentBuffer) {
+            std::cout << "OpenGLReadbackBuffer::PreAllocate() failed because glMapNamedBufferRange returned nullptr\n";
+        }
+    }
+
+    // Binds the segment the GPU writes this frame
+    void BindWriteRange(GLenum target, GLuint index) const {
+        glBindBufferRange(target, index, m_handle, (GLintptr)(m_writeIndex * m_segmentSize), (GLsizeiptr)m_segmentSize);
+    }
+
+    int GetWriteIndex() const {
+        return m_writeIndex;
+    }
+
+    // Segment ended most recently, for GPU consumers later in the same frame
+    int GetLastWriteIndex() const {
+        return (m_writeIndex + FRAME_COUNT - 1) % FRAME_COUNT;
+    }
+
+    void BindLastWriteRange(GLenum target, GLuint index) const {
+        glBindBufferRange(target, index, m_handle, (GLintptr)(GetLastWriteIndex() * m_segmentSize), (GLsizeiptr)m_segmentSize);
+    }
+
+    // Call once the commands writing the segment are submitted
+    void EndWrite() {
+        glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+        if (m_fences[m_writeIndex]) {
+            glDeleteSync(m_fences[m_writeIndex]);
+        }
+        m_fences[m_writeIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_writeIndex = (m_writeIndex + 1) % FRAME_COUNT;
+    }
+
+    // Newest segment the GPU has finished with, or nullptr if none has completed yet
+    const GLubyte* GetLatestResult(int& segmentIndex) {
+        if (!m_persistentBuffer) {
+            return nullptr;
+        }
+        for (int age = 1; age <= FRAME_COUNT; age++) {
+            int index = (m_writeIndex - age + FRAME_COUNT) % FRAME_COUNT;
+            GLsync& fence = m_fences[index];
+            if (!fence) {
+                continue;
+            }
+            GLenum result = glClientWaitSync(fence, 0, 0);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+                segmentIndex = index;
+                return m_persistentBuffer + index * m_segmentSize;
+            }
+        }
+        return nullptr;
+    }
+
+    void CleanUp() {
+        for (GLsync& fence : m_fences) {
+            if (fence) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        if (m_persistentBuffer) {
+            glUnmapNamedBuffer(m_handle);
+            m_persistentBuffer = nullptr;
+        }
+        if (m_handle != 0) {
+            glDeleteBuffers(1, &m_handle);
+            m_handle = 0;
+        }
+        m_segmentSize = 0;
+        m_writeIndex = 0;
+    }
+
+private:
+    GLubyte* m_persistentBuffer = nullptr;
+    uint32_t m_handle = 0;
+    size_t m_segmentSize = 0;
+    int m_writeIndex = 0;
+    GLsync m_fences[FRAME_COUNT] = {};
+};
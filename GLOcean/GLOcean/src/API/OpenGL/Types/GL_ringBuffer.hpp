@@ -0,0 +1,96 @@
+#pragma once
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+// Persistently mapped buffer split into one segment per frame in flight. The CPU writes the current segment
+// while the GPU still reads the older ones, a fence per segment stops the CPU from lapping the GPU.
+struct OpenGLRingBuffer {
+public:
+    static constexpr int FRAME_COUNT = 3;
+
+    void PreAllocate(size_t segmentSize) {
+        CleanUp();
+
+        // Segments are bound with glBindBufferRange, so each offset must satisfy both UBO and SSBO alignment
+        GLint uniformAlignment = 256;
+        GLint storageAlignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+        size_t alignment = (size_t)std::max(uniformAlignment, storageAlignment);
+        m_segmentSize = (segmentSize + alignment - 1) / alignment * alignment;
+
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &m_handle);
+        glNamedBufferStorage(m_handle, (GLsizeiptr)(m_segmentSize * FRAME_COUNT), nullptr, flags);
+        m_persistentBuffer = (GLubyte*)glMapNamedBufferRange(m_handle, 0, (GLsizeiptr)(m_segmentSize * FRAME_COUNT), flags);
+        if (!m_persistentBuffer) {
+            std::cout << "OpenGLRingBuffer::PreAllocate() failed because glMapNamedBufferRange returned nullptr\n";
+        }
+    }
+
+    // Moves to the next segment, blocking only if the GPU has not finished with it yet
+    void BeginFrame() {
+        m_frameIndex = (m_frameIndex + 1) % FRAME_COUNT;
+        GLsync& fence = m_fences[m_frameIndex];
+        if (fence) {
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            while (result == GL_TIMEOUT_EXPIRED) {
+                result = glClientWaitSync(fence, 0, 1000000);
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    void EndFrame() {
+        m_fences[m_frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void BindRange(GLenum target, GLuint index) const {
+        glBindBufferRange(target, index, m_handle, (GLintptr)(m_frameIndex * m_segmentSize), (GLsizeiptr)m_segmentSize);
+    }
+
+    size_t GetSegmentOffset() const {
+        return m_frameIndex * m_segmentSize;
+    }
+
+    GLubyte* GetSegmentPointer() const {
+        return m_persistentBuffer ? m_persistentBuffer + m_frameIndex * m_segmentSize : nullptr;
+    }
+
+    size_t GetSegmentSize() const {
+        return m_segmentSize;
+    }
+
+    uint32_t GetHandle() const {
+        return m_handle;
+    }
+
+    void CleanUp() {
+        for (GLsync& fence : m_fences) {
+            if (fence) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        if (m_persistentBuffer) {
+            glUnmapNamedBuffer(m_handle);
+            m_persistentBuffer = nullptr;
+        }
+        if (m_handle != 0) {
+            glDeleteBuffers(1, &m_handle);
+            m_handle = 0;
+        }
+        m_segmentSize = 0;
+        m_frameIndex = 0;
+    }
+
+private:
+    GLubyte* m_persistentBuffer = nullptr;
+    uint32_t m_handle = 0;
+    size_t m_segmentSize = 0;
+    int m_frameIndex = 0;
+    GLsync m_fences[FRAME_COUNT] = {};
+};
@@ -1,10 +1,12 @@
 #include "GL_shader.h"
+#include "../GL_state.hpp"
 #include <glad/glad.h>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <regex>
+#include <cstring>
 
 void ParseFile(const std::string& filepath, std::string& outputString, std::vector<std::string>& lineToFile, std::vector<std::string>& includedPaths);
 int GetErrorLineNumber(const std::string& error);
@@ -13,7 +15,7 @@ std::string GetLinkingErrors(unsigned int shader);
 std::string GetShaderCompileErrors(unsigned int shader, const std::string& filename, const std::vector<std::string>& lineToFile);
 
 void Shader::Use() {
-    glUseProgram(m_handle);
+    OpenGLState::UseProgram(m_handle);
 }
 
 bool Shader::Load(std::vector<std::string> shaderPaths) {
@@ -77,7 +79,7 @@ bool Shader::Load(std::vector<std::string> shaderPaths) {
         glDeleteProgram(m_handle);
     }
     m_handle = tempHandle;
-    m_uniformLocations.clear();
+    ResolveUniformLocations();
 
     /*
     // Auto-bind samplers declared with layout(binding=N)
@@ -125,95 +127,150 @@ bool Shader::Load(std::vector<std::string> shaderPaths) {
     return true;
 }
 
-void Shader::SetBool(const std::string& name, bool value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform1i(m_uniformLocations[name], (int)value);
+void Shader::SetBool(UniformName name, bool value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetInt(const std::string& name, int value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform1i(m_uniformLocations[name], value);
+void Shader::SetInt(UniformName name, int value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetFloat(const std::string& name, float value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform1f(m_uniformLocations[name], value);
+void Shader::SetFloat(UniformName name, float value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetMat2(const std::string& name, const glm::mat2& mat) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniformMatrix2fv(m_uniformLocations[name], 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat2(UniformName name, const glm::mat2& mat) {
+    SetUniform(GetUniformLocation(name.hash), mat);
 }
 
-void Shader::SetMat3(const std::string& name, const glm::mat3& mat) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniformMatrix3fv(m_uniformLocations[name], 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat3(UniformName name, const glm::mat3& mat) {
+    SetUniform(GetUniformLocation(name.hash), mat);
 }
 
-void Shader::SetMat4(const std::string& name, glm::mat4 value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniformMatrix4fv(m_uniformLocations[name], 1, GL_FALSE, &value[0][0]);
+void Shader::SetMat4(UniformName name, const glm::mat4& value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetUvec2(const std::string& name, const glm::uvec2& value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform2uiv(m_uniformLocations[name], 1, &value[0]);
+void Shader::SetUvec2(UniformName name, const glm::uvec2& value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetVec2(const std::string& name, const glm::vec2& value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform2fv(m_uniformLocations[name], 1, &value[0]);
+void Shader::SetVec2(UniformName name, const glm::vec2& value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetVec3(const std::string& name, const glm::vec3& value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform3fv(m_uniformLocations[name], 1, &value[0]);
+void Shader::SetVec3(UniformName name, const glm::vec3& value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetVec4(const std::string& name, const glm::vec4& value) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform4fv(m_uniformLocations[name], 1, &value[0]);
+void Shader::SetVec4(UniformName name, const glm::vec4& value) {
+    SetUniform(GetUniformLocation(name.hash), value);
 }
 
-void Shader::SetVec2(const std::string& name, float x, float y) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
-    }
-    glUniform2f(m_uniformLocations[name], x, y);
+void Shader::SetVec2(UniformName name, float x, float y) {
+    glUniform2f(GetUniformLocation(name.hash), x, y);
+}
+
+void Shader::SetVec3(UniformName name, float x, float y, float z) {
+    glUniform3f(GetUniformLocation(name.hash), x, y, z);
+}
+
+void Shader::SetVec4(UniformName name, float x, float y, float z, float w) {
+    glUniform4f(GetUniformLocation(name.hash), x, y, z, w);
+}
+
+void Shader::SetUniform(int location, bool value) {
+    glUniform1i(location, (int)value);
+}
+
+void Shader::SetUniform(int location, int value) {
+    glUniform1i(location, value);
+}
+
+void Shader::SetUniform(int location, float value) {
+    glUniform1f(location, value);
+}
+
+void Shader::SetUniform(int location, const glm::vec2& value) {
+    glUniform2fv(location, 1, &value[0]);
+}
+
+void Shader::SetUniform(int location, const glm::vec3& value) {
+    glUniform3fv(location, 1, &value[0]);
+}
+
+void Shader::SetUniform(int location, const glm::vec4& value) {
+    glUniform4fv(location, 1, &value[0]);
+}
+
+void Shader::SetUniform(int location, const glm::uvec2& value) {
+    glUniform2uiv(location, 1, &value[0]);
+}
+
+void Shader::SetUniform(int location, const glm::mat2& value) {
+    glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::SetUniform(int location, const glm::mat3& value) {
+    glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::SetUniform(int location, const glm::mat4& value) {
+    glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+// Missing uniforms resolve to -1, which glUniform* silently ignores
+int Shader::GetUniformLocation(uint32_t hash) {
+    auto it = m_uniformLocations.find(hash);
+    return (it != m_uniformLocations.end()) ? it->second : -1;
 }
 
-void Shader::SetVec3(const std::string& name, float x, float y, float z) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
+int Shader::GetUniformHandleIndex(uint32_t hash) {
+    for (int i = 0; i < m_handleHashes.size(); i++) {
+        if (m_handleHashes[i] == hash) {
+            return i;
+        }
     }
-    glUniform3f(m_uniformLocations[name], x, y, z);
+    m_handleHashes.push_back(hash);
+    m_handleLocations.push_back(GetUniformLocation(hash));
+    return (int)m_handleHashes.size() - 1;
 }
 
-void Shader::SetVec4(const std::string& name, float x, float y, float z, float w) {
-    if (m_uniformLocations.find(name) == m_uniformLocations.end()) {
-        m_uniformLocations[name] = glGetUniformLocation(m_handle, name.c_str());
+void Shader::ResolveUniformLocations() {
+    m_uniformLocations.clear();
+
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramInterfaceiv(m_handle, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+    glGetProgramInterfaceiv(m_handle, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+    std::vector<char> name(maxNameLength + 1);
+
+    for (int i = 0; i < uniformCount; i++) {
+        GLenum property = GL_LOCATION;
+        GLint location = -1;
+        glGetProgramResourceiv(m_handle, GL_UNIFORM, i, 1, &property, 1, nullptr, &location);
+        if (location == -1) {
+            continue; // Block member
+        }
+        glGetProgramResourceName(m_handle, GL_UNIFORM, i, (GLsizei)name.size(), nullptr, name.data());
+
+        // Arrays are reported as "name[0]", register the bare name too
+        uint32_t hash = HashUniformName(name.data());
+        if (m_uniformLocations.contains(hash)) {
+            std::cout << "Shader::ResolveUniformLocations() found a hash collision on uniform '" << name.data() << "'\n";
+        }
+        m_uniformLocations[hash] = location;
+        char* bracket = strchr(name.data(), '[');
+        if (bracket) {
+            *bracket = '\0';
+            m_uniformLocations[HashUniformName(name.data())] = location;
+        }
+    }
+
+    // Refresh handles handed out before a hot reload
+    for (int i = 0; i < m_handleHashes.size(); i++) {
+        m_handleLocations[i] = GetUniformLocation(m_handleHashes[i]);
     }
-    glUniform4f(m_uniformLocations[name], x, y, z, w);
 }
 
 int Shader::GetHandle() {
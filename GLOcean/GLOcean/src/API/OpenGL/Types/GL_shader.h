@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -19,25 +20,76 @@ private:
     std::vector<std::string> m_lineMap;
 };
 
+// FNV-1a. Evaluated at compile time for string literals, so setting a uniform by name neither allocates nor hashes at runtime
+constexpr uint32_t HashUniformName(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
+
+struct UniformName {
+    template <size_t N>
+    consteval UniformName(const char (&name)[N]) : hash(HashUniformName(name)), name(name) {}
+    uint32_t hash;
+    const char* name;
+};
+
+// Slot in a shader's handle table, the location behind it is re-resolved on every Load so it survives hot reloading
+template <typename T>
+struct UniformHandle {
+    int index = -1;
+};
+
 struct Shader {
 public:
     void Use();
     bool Load(std::vector<std::string> shaderPaths);
-    void SetInt(const std::string& name, int value);
-    void SetBool(const std::string& name, bool value);
-    void SetFloat(const std::string& name, float value);
-    void SetMat2(const std::string& name, const glm::mat2& mat);
-    void SetMat3(const std::string& name, const glm::mat3& mat);
-    void SetMat4(const std::string& name, glm::mat4 value);
-    void SetVec2(const std::string& name, const glm::vec2& value);
-    void SetVec4(const std::string& name, const glm::vec4& value);
-    void SetVec3(const std::string& name, const glm::vec3& value);
-    void SetVec2(const std::string& name, float x, float y);
-    void SetVec3(const std::string& name, float x, float y, float z);
-    void SetVec4(const std::string& name, float x, float y, float z, float w);
-    void SetUvec2(const std::string& name, const glm::uvec2& value);
+    void SetInt(UniformName name, int value);
+    void SetBool(UniformName name, bool value);
+    void SetFloat(UniformName name, float value);
+    void SetMat2(UniformName name, const glm::mat2& mat);
+    void SetMat3(UniformName name, const glm::mat3& mat);
+    void SetMat4(UniformName name, const glm::mat4& value);
+    void SetVec2(UniformName name, const glm::vec2& value);
+    void SetVec4(UniformName name, const glm::vec4& value);
+    void SetVec3(UniformName name, const glm::vec3& value);
+    void SetVec2(UniformName name, float x, float y);
+    void SetVec3(UniformName name, float x, float y, float z);
+    void SetVec4(UniformName name, float x, float y, float z, float w);
+    void SetUvec2(UniformName name, const glm::uvec2& value);
     int GetHandle();
+
+    template <typename T>
+    UniformHandle<T> GetUniformHandle(UniformName name) {
+        return UniformHandle<T>{ GetUniformHandleIndex(name.hash) };
+    }
+
+    template <typename T>
+    void Set(UniformHandle<T> handle, const T& value) {
+        if (handle.index >= 0 && handle.index < m_handleLocations.size()) {
+            SetUniform(m_handleLocations[handle.index], value);
+        }
+    }
+
 private:
-    std::unordered_map<std::string, int> m_uniformLocations;
+    int GetUniformLocation(uint32_t hash);
+    int GetUniformHandleIndex(uint32_t hash);
+    void ResolveUniformLocations();
+    void SetUniform(int location, bool value);
+    void SetUniform(int location, int value);
+    void SetUniform(int location, float value);
+    void SetUniform(int location, const glm::vec2& value);
+    void SetUniform(int location, const glm::vec3& value);
+    void SetUniform(int location, const glm::vec4& value);
+    void SetUniform(int location, const glm::uvec2& value);
+    void SetUniform(int location, const glm::mat2& value);
+    void SetUniform(int location, const glm::mat3& value);
+    void SetUniform(int location, const glm::mat4& value);
+
+    std::unordered_map<uint32_t, int> m_uniformLocations;
+    std::vector<uint32_t> m_handleHashes;
+    std::vector<int> m_handleLocations;
     int m_handle = -1;
 };
\ No newline at end of file
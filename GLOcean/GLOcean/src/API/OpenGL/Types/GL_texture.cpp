@@ -7,7 +7,7 @@
 #include "../GL_util.hpp"
 #include "tinyexr.h"
 
-#define ALLOW_BINDLESS_TEXTURES 0
+#define ALLOW_BINDLESS_TEXTURES 1
 
 GLuint64 OpenGLTexture::GetBindlessID() {
     return m_bindlessID;
@@ -203,7 +203,7 @@ void OpenGLTexture::MakeBindlessTextureResident() {
 
 void OpenGLTexture::MakeBindlessTextureNonResident() {
 #if ALLOW_BINDLESS_TEXTURES
-    if (m_bindlessID == 0) {
+    if (m_bindlessID != 0) {
         glMakeTextureHandleNonResidentARB(m_bindlessID);
     }
 #endif
@@ -0,0 +1,75 @@
+#pragma once
+#include <glad/glad.h>
+#include <iostream>
+#include <string>
+#include <format>
+
+// GPU side equivalent of Timer.hpp. Results are read back a few frames late to avoid stalling the pipeline.
+// Timestamp pairs rather than GL_TIME_ELAPSED so timers can nest, e.g. a pass inside the whole frame.
+struct OpenGLTimerQuery {
+public:
+    static constexpr int QUERY_COUNT = 4;
+
+    void Begin() {
+        if (m_handles[0] == 0) {
+            glCreateQueries(GL_TIMESTAMP, QUERY_COUNT * 2, m_handles);
+        }
+        int index = m_frameIndex % QUERY_COUNT;
+        if (m_frameIndex >= QUERY_COUNT) {
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(m_handles[index * 2], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(m_handles[index * 2 + 1], GL_QUERY_RESULT, &end);
+            m_lastTime = (end - begin) / 1000000.0f;
+            m_allTimes += m_lastTime;
+            m_sampleCount++;
+        }
+        glQueryCounter(m_handles[index * 2], GL_TIMESTAMP);
+    }
+
+    void End() {
+        int index = m_frameIndex % QUERY_COUNT;
+        glQueryCounter(m_handles[index * 2 + 1], GL_TIMESTAMP);
+        m_frameIndex++;
+    }
+
+    void Reset() {
+        m_allTimes = 0;
+        m_sampleCount = 0;
+    }
+
+    float GetLastTime() const {
+        return m_lastTime;
+    }
+
+    float GetAverageTime() const {
+        return (m_sampleCount > 0) ? (m_allTimes / m_sampleCount) : 0.0f;
+    }
+
+    void Print(const std::string& name) const {
+        std::string spacing;
+        int extraSpaces = 50 - static_cast<int>(name.length());
+        for (int i = 0; i < extraSpaces; i++) {
+            spacing += " ";
+        }
+        std::cout << name << ":" << spacing
+            << std::format("{:.4f}", m_lastTime) << "ms      average: "
+            << std::format("{:.4f}", GetAverageTime()) << "ms\n";
+    }
+
+    void CleanUp() {
+        if (m_handles[0] != 0) {
+            glDeleteQueries(QUERY_COUNT * 2, m_handles);
+            m_handles[0] = 0;
+        }
+        m_frameIndex = 0;
+        Reset();
+    }
+
+private:
+    GLuint m_handles[QUERY_COUNT * 2] = {};
+    int m_frameIndex = 0;
+    float m_lastTime = 0;
+    float m_allTimes = 0;
+    float m_sampleCount = 0;
+};
@@ -17,6 +17,7 @@ namespace AssetManager {
     std::unordered_map<std::string, int> g_textureIndexMap;
     std::unordered_map<std::string, int> g_materialIndexMap;
     std::unordered_map<std::string, int> g_modelIndexMap;
+    uint32_t g_materialRevision = 0;
 
     void LoadMinimum();
     void LoadModelsAsync();
@@ -38,7 +39,11 @@ namespace AssetManager {
 
     void Update() {
         for (Texture& texture : g_textures) {
+            bool wasBakeComplete = texture.BakeComplete();
             texture.CheckForBakeCompletion();
+            if (!wasBakeComplete && texture.BakeComplete()) {
+                g_materialRevision++;
+            }
         }
 
         static bool baked = false;
@@ -72,11 +77,11 @@ namespace AssetManager {
         for (FileInfo& fileInfo : Util::IterateDirectory("res/models_raw", { "obj", "fbx" })) {
             std::string assetPath = "res/models/" + fileInfo.name + ".model";
 
-            // If the file exists but timestamps don't match, re-export
+            // If the file exists but timestamps or format version don't match, re-export
             if (Util::FileExists(assetPath)) {
                 uint64_t lastModified = File::GetLastModifiedTime(fileInfo.path);
                 ModelHeader modelHeader = File::ReadModelHeader(assetPath);
-                if (modelHeader.timestamp != lastModified) {
+                if (modelHeader.timestamp != lastModified || modelHeader.version != MODEL_FILE_VERSION) {
                     File::DeleteFile(assetPath);
                     ModelData modelData = AssimpImporter::ImportFbx(fileInfo.path);
                     File::ExportModel(modelData);
@@ -106,12 +111,16 @@ namespace AssetManager {
     █ █ █ █▀▀ ▀▀█ █▀█
     ▀   ▀ ▀▀▀ ▀▀▀ ▀ ▀ */
 
-    int CreateMesh(const std::string& name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, glm::vec3 aabbMin, glm::vec3 aabbMax) {
+    int CreateMesh(const std::string& name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, glm::vec3 aabbMin, glm::vec3 aabbMax, const std::vector<MeshLod>& lods, const std::vector<Meshlet>& meshlets) {
         OpenGLDetachedMesh& mesh = g_meshes.emplace_back();
         mesh.SetName(name);
-        mesh.UpdateVertexBuffer(vertices, indices);
         mesh.aabbMin = aabbMin;
         mesh.aabbMax = aabbMax;
+        OpenGLBackend::UploadStaticMesh(mesh, vertices, indices);
+        for (const MeshLod& lod : lods) {
+            OpenGLBackend::UploadStaticMeshLod(mesh, lod.indices, lod.error);
+        }
+        OpenGLBackend::UploadStaticMeshMeshlets(mesh, meshlets);
         return g_meshes.size() - 1;
     }
 
@@ -141,9 +150,9 @@ namespace AssetManager {
         }
         OpenGLDetachedMesh& mesh = g_meshes.emplace_back();
         mesh.SetName(name);
-        mesh.UpdateVertexBuffer(vertices, indices);
         mesh.aabbMin = aabbMin;
         mesh.aabbMax = aabbMax;
+        OpenGLBackend::UploadStaticMesh(mesh, vertices, indices);
         return g_meshes.size() - 1;
     }
 
@@ -384,7 +393,7 @@ namespace AssetManager {
         model.SetName(modelData.name);
         model.SetAABB(modelData.aabbMin, modelData.aabbMax);
         for (MeshData& meshData : modelData.meshes) {
-            int meshIndex = CreateMesh(meshData.name, meshData.vertices, meshData.indices, meshData.aabbMin, meshData.aabbMax);
+            int meshIndex = CreateMesh(meshData.name, meshData.vertices, meshData.indices, meshData.aabbMin, meshData.aabbMax, meshData.lods, meshData.meshlets);
             model.AddMeshIndex(meshIndex);
         }
     }
@@ -438,6 +447,10 @@ namespace AssetManager {
     std::string& GetMaterialNameByIndex(int index) {
         return g_materials[index].m_name;
     }
+
+    uint32_t GetMaterialRevision() {
+        return g_materialRevision;
+    }
 }
 
 
@@ -23,7 +23,7 @@ namespace AssetManager {
     Model* GetModelByIndex(int index);
 
     // Mesh
-    int CreateMesh(const std::string& name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, glm::vec3 aabbMin, glm::vec3 aabbMax);
+    int CreateMesh(const std::string& name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, glm::vec3 aabbMin, glm::vec3 aabbMax, const std::vector<MeshLod>& lods = {}, const std::vector<Meshlet>& meshlets = {});
     int CreateMesh(const std::string& name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
     int GetMeshIndexByName(const std::string& name);
     int GetMeshIndexByName(const std::string& name);
@@ -35,4 +35,5 @@ namespace AssetManager {
     Material* GetMaterialByIndex(int index);
     int GetMaterialIndex(const std::string& name);
     std::string& GetMaterialNameByIndex(int index);
+    uint32_t GetMaterialRevision(); // Bumped whenever a texture finishes baking, which changes what GetMaterialByIndex() resolves to
 }
\ No newline at end of file
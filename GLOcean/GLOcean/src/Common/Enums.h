@@ -22,6 +22,11 @@ enum class BlendingMode {
     DO_NOT_RENDER 
 };
 
+enum class VertexFormat {
+    FLOAT32,
+    QUANTIZED
+};
+
 enum class ImageDataType {
     UNCOMPRESSED,
     COMPRESSED,
@@ -42,4 +47,16 @@ enum class TextureFilter {
     LINEAR,
     LINEAR_MIPMAP,
     UNDEFINED
-};
\ No newline at end of file
+};
+
+enum class OceanTextureFormat {
+    FULL_PRECISION,     // RGBA32F displacement, RG16F normals
+    HALF_PRECISION,     // RGBA16F displacement, RG16F normals
+    COMPACT,            // RGBA16F displacement, RG8_SNORM normals
+    COUNT
+};
+enum class HairRenderMode {
+    DEPTH_PEELING,          // peelCount geometry passes per layer
+    WEIGHTED_BLENDED_OIT,   // single geometry pass per layer, order independent
+    COUNT
+};
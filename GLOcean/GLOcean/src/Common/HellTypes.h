@@ -9,9 +9,13 @@
 struct RenderItem {
     glm::mat4 modelMatrix;
     int meshIndex;
-    int baseColorTextureIndex;
-    int normalTextureIndex;
-    int rmaTextureIndex;
+    int baseColorTextureIndex = 0;
+    int normalTextureIndex = 0;
+    int rmaTextureIndex = 0;
+    int materialIndex = -1;
+    int gameObjectIndex = -1;
+    int lodIndex = 0;
+    uint64_t sortKey = 0;
 };
 
 struct FontVertex {
@@ -51,6 +55,16 @@ struct Vertex {
     glm::vec3 tangent = glm::vec3(0);
 };
 
+// 20 byte form of Vertex used on the GPU and optionally on disk. Positions are unorm against the mesh AABB,
+// normal and tangent are octahedral in the x and y of a 2_10_10_10 snorm word, UVs are half floats
+struct CompactVertex {
+    uint16_t position[3];
+    uint16_t padding;
+    uint32_t normal;
+    uint32_t tangent;
+    uint16_t uv[2];
+};
+
 struct TextureData {
     int m_width = 0;
     int m_height = 0;
@@ -13,6 +13,9 @@ namespace Camera {
     float g_mouseSensitivity = 0.002f;
     float g_walkSpeed = 5.0f;
     GLFWwindow* g_window;
+    CameraFrameData g_frameData;
+
+    void UpdateFrameData();
 
     void Init(GLFWwindow* window) {
         g_window = window;
@@ -25,6 +28,7 @@ namespace Camera {
         g_mouseOffsetY = y;
         g_mouseX = x;
         g_mouseY = y;
+        UpdateFrameData();
     }
 
     void Update(float deltaTime) {
@@ -39,8 +43,9 @@ namespace Camera {
         g_transform.rotation.y += -g_mouseOffsetX * g_mouseSensitivity;
         g_transform.rotation.x = std::min(g_transform.rotation.x, 1.5f);
         g_transform.rotation.x = std::max(g_transform.rotation.x, -1.5f);
-        glm::vec3 camRight = glm::vec3(g_transform.to_mat4()[0]);
-        glm::vec3 camForward = glm::vec3(g_transform.to_mat4()[2]);
+        glm::mat4 cameraMatrix = g_transform.to_mat4();
+        glm::vec3 camRight = glm::vec3(cameraMatrix[0]);
+        glm::vec3 camForward = glm::vec3(cameraMatrix[2]);
         glm::vec3 movementForwardVector = glm::normalize(glm::vec3(camForward.x, 0, camForward.z));
 
         //std::cout << g_transform.rotation.x << ", " << g_transform.rotation.y << "\n";
@@ -75,20 +80,59 @@ namespace Camera {
         if (Input::KeyDown(GLFW_KEY_E)) {
             g_transform.position.y -= deltaTime * heightSpeed * speedFactor;
         }
+        UpdateFrameData();
     }
 
-    glm::mat4 GetProjectionMatrix() {
+    // Gribb/Hartmann, each plane is a sum or difference of the bottom row and one other row of the projection view matrix
+    void ExtractFrustumPlanes(const glm::mat4& m, glm::vec4* planes) {
+        glm::vec4 row0 = glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1 = glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2 = glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3 = glm::vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+        planes[0] = row3 + row0;
+        planes[1] = row3 - row0;
+        planes[2] = row3 + row1;
+        planes[3] = row3 - row1;
+        planes[4] = row3 + row2;
+        planes[5] = row3 - row2;
+        for (int i = 0; i < 6; i++) {
+            planes[i] /= glm::length(glm::vec3(planes[i]));
+        }
+    }
+
+    void UpdateFrameData() {
         int width, height;
         glfwGetWindowSize(g_window, &width, &height);
-        return glm::perspective(1.0f, float(width) / float(height), NEAR_PLANE, FAR_PLANE);
+        if (width > 0 && height > 0) {
+            g_frameData.projection = glm::perspective(1.0f, float(width) / float(height), NEAR_PLANE, FAR_PLANE);
+            g_frameData.inverseProjection = glm::inverse(g_frameData.projection);
+            g_frameData.viewportSize = glm::vec2(width, height);
+        }
+        g_frameData.inverseView = g_transform.to_mat4();
+        g_frameData.view = glm::inverse(g_frameData.inverseView);
+        g_frameData.projectionView = g_frameData.projection * g_frameData.view;
+        g_frameData.inverseProjectionView = g_frameData.inverseView * g_frameData.inverseProjection;
+        g_frameData.viewPos = g_transform.position;
+        g_frameData.right = glm::vec3(g_frameData.inverseView[0]);
+        g_frameData.up = glm::vec3(g_frameData.inverseView[1]);
+        g_frameData.forward = -glm::vec3(g_frameData.inverseView[2]);
+        ExtractFrustumPlanes(g_frameData.projectionView, g_frameData.frustumPlanes);
+    }
+
+    const CameraFrameData& GetFrameData() {
+        return g_frameData;
+    }
+
+    glm::mat4 GetProjectionMatrix() {
+        return g_frameData.projection;
     }
 
     glm::mat4 GetViewMatrix() {
-        return glm::inverse(g_transform.to_mat4());
+        return g_frameData.view;
     }
 
     glm::mat4 GetInverseViewMatrix() {
-        return g_transform.to_mat4();
+        return g_frameData.inverseView;
     }
 
     glm::vec3 GetViewRotation() {
@@ -104,14 +148,15 @@ namespace Camera {
     }
 
     glm::vec3 GetForward() {
-       return -glm::vec3(GetViewMatrix()[0][2], GetViewMatrix()[1][2], GetViewMatrix()[2][2]);
+        return g_frameData.forward;
     }
 
     glm::vec3 GetRight() {
-        return glm::vec3(GetInverseViewMatrix()[0]);
+        return g_frameData.right;
     }
+
     glm::vec3 GetUp() {
-        return glm::vec3(GetInverseViewMatrix()[1]);
+        return g_frameData.up;
     }
 }
 
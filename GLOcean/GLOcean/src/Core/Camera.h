@@ -6,9 +6,26 @@
 #define NEAR_PLANE 0.01f
 #define FAR_PLANE 20.0f
 
+// Everything the passes need from the camera, computed once per frame by Camera::Update()
+struct CameraFrameData {
+    glm::mat4 view = glm::mat4(1);
+    glm::mat4 projection = glm::mat4(1);
+    glm::mat4 inverseView = glm::mat4(1);
+    glm::mat4 inverseProjection = glm::mat4(1);
+    glm::mat4 projectionView = glm::mat4(1);
+    glm::mat4 inverseProjectionView = glm::mat4(1);
+    glm::vec3 viewPos = glm::vec3(0);
+    glm::vec3 forward = glm::vec3(0, 0, -1);
+    glm::vec3 right = glm::vec3(1, 0, 0);
+    glm::vec3 up = glm::vec3(0, 1, 0);
+    glm::vec2 viewportSize = glm::vec2(1);
+    glm::vec4 frustumPlanes[6];     // Left, right, bottom, top, near, far. Normals point inwards, dot(plane.xyz, p) + plane.w >= 0 is inside
+};
+
 namespace Camera {
     void Init(GLFWwindow* window);
     void Update(float deltaTime);
+    const CameraFrameData& GetFrameData();
     glm::mat4 GetProjectionMatrix();
     glm::mat4 GetViewMatrix();
     glm::mat4 GetInverseViewMatrix();
@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "HellTypes.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define CULLING_SSE 1
+#else
+#define CULLING_SSE 0
+#endif
+
+namespace Culling {
+
+    // Max depth per screen tile of the previous frame, read back from the GPU
+    struct OcclusionDepthBuffer {
+        int width = 0;
+        int height = 0;
+        glm::mat4 projectionView = glm::mat4(1);
+        std::vector<float> depths;
+        bool valid = false;
+    };
+
+    // World space center and half extent of a local AABB under an affine matrix (Arvo)
+    inline void TransformAABB(const glm::mat4& m, const glm::vec3& aabbMin, const glm::vec3& aabbMax, glm::vec3& center, glm::vec3& extent) {
+        glm::vec3 localCenter = (aabbMin + aabbMax) * 0.5f;
+        glm::vec3 localExtent = (aabbMax - aabbMin) * 0.5f;
+#if CULLING_SSE
+        __m128 c0 = _mm_loadu_ps(&m[0][0]);
+        __m128 c1 = _mm_loadu_ps(&m[1][0]);
+        __m128 c2 = _mm_loadu_ps(&m[2][0]);
+        __m128 c3 = _mm_loadu_ps(&m[3][0]);
+        __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 worldCenter = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(localCenter.x)));
+        worldCenter = _mm_add_ps(worldCenter, _mm_mul_ps(c1, _mm_set1_ps(localCenter.y)));
+        worldCenter = _mm_add_ps(worldCenter, _mm_mul_ps(c2, _mm_set1_ps(localCenter.z)));
+        __m128 worldExtent = _mm_mul_ps(_mm_andnot_ps(signMask, c0), _mm_set1_ps(localExtent.x));
+        worldExtent = _mm_add_ps(worldExtent, _mm_mul_ps(_mm_andnot_ps(signMask, c1), _mm_set1_ps(localExtent.y)));
+        worldExtent = _mm_add_ps(worldExtent, _mm_mul_ps(_mm_andnot_ps(signMask, c2), _mm_set1_ps(localExtent.z)));
+        alignas(16) float centerOut[4];
+        alignas(16) float extentOut[4];
+        _mm_store_ps(centerOut, worldCenter);
+        _mm_store_ps(extentOut, worldExtent);
+        center = glm::vec3(centerOut[0], centerOut[1], centerOut[2]);
+        extent = glm::vec3(extentOut[0], extentOut[1], extentOut[2]);
+#else
+        center = glm::vec3(m * glm::vec4(localCenter, 1.0f));
+        glm::mat3 absolute = glm::mat3(glm::abs(glm::vec3(m[0])), glm::abs(glm::vec3(m[1])), glm::abs(glm::vec3(m[2])));
+        extent = absolute * localExtent;
+#endif
+    }
+
+    // False only if the box lies entirely behind one of the planes
+    inline bool AABBInFrustum(const glm::vec4* planes, const glm::vec3& center, const glm::vec3& extent) {
+        for (int i = 0; i < 6; i++) {
+            const glm::vec4& plane = planes[i];
+            float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+            if (distance + radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // True if every tile the box covers holds something closer than the box's nearest point
+    inline bool AABBOccluded(const OcclusionDepthBuffer& depthBuffer, const glm::vec3& center, const glm::vec3& extent) {
+        if (!depthBuffer.valid || depthBuffer.width <= 0 || depthBuffer.height <= 0) {
+            return false;
+        }
+        glm::vec2 ndcMin = glm::vec2(1.0f);
+        glm::vec2 ndcMax = glm::vec2(-1.0f);
+        float nearestDepth = 1.0f;
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner = center + extent * glm::vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+            glm::vec4 clip = depthBuffer.projectionView * glm::vec4(corner, 1.0f);
+            if (clip.w <= 0.0001f) {
+                return false; // Crosses the near plane
+            }
+            glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            ndcMin = glm::min(ndcMin, glm::vec2(ndc));
+            ndcMax = glm::max(ndcMax, glm::vec2(ndc));
+            nearestDepth = std::min(nearestDepth, ndc.z * 0.5f + 0.5f);
+        }
+        int x0 = std::clamp((int)std::floor((ndcMin.x * 0.5f + 0.5f) * depthBuffer.width), 0, depthBuffer.width - 1);
+        int x1 = std::clamp((int)std::floor((ndcMax.x * 0.5f + 0.5f) * depthBuffer.width), 0, depthBuffer.width - 1);
+        int y0 = std::clamp((int)std::floor((ndcMin.y * 0.5f + 0.5f) * depthBuffer.height), 0, depthBuffer.height - 1);
+        int y1 = std::clamp((int)std::floor((ndcMax.y * 0.5f + 0.5f) * depthBuffer.height), 0, depthBuffer.height - 1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                if (nearestDepth <= depthBuffer.depths[y * depthBuffer.width + x]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
@@ -1,9 +1,13 @@
 #pragma once
+#include <algorithm>
 #include <vector>
 #include "../AssetManagement/AssetManager.h"
+#include "../Core/Camera.h"
+#include "../Core/Culling.hpp"
 #include "../Input/Input.h"
 #include "../Types/GameObject.h"
 #include "../Util.hpp"
+#include "../Timer.hpp"
 #include "HellTypes.h"
 
 namespace Scene {
@@ -14,31 +18,158 @@ namespace Scene {
     inline std::vector<RenderItem> g_renderItemsAlphaDiscarded;
     inline std::vector<RenderItem> g_renderItemsHairTopLayer;
     inline std::vector<RenderItem> g_renderItemsHairBottomLayer;
+    inline std::vector<std::vector<RenderItem*>> g_gameObjectRenderItems; // Where each object's items sit in the sorted lists above
+    inline uint32_t g_renderListsMaterialRevision = 0xFFFFFFFF;
+
+    // What the passes actually draw, the lists above filtered by culling each frame
+    inline std::vector<RenderItem> g_visibleRenderItems;
+    inline std::vector<RenderItem> g_visibleRenderItemsBlended;
+    inline std::vector<RenderItem> g_visibleRenderItemsAlphaDiscarded;
+    inline std::vector<RenderItem> g_visibleRenderItemsHairTopLayer;
+    inline std::vector<RenderItem> g_visibleRenderItemsHairBottomLayer;
+    inline Culling::OcclusionDepthBuffer g_occlusionDepthBuffer;
+    inline bool g_frustumCulling = true;
+    inline bool g_occlusionCulling = false;
+    inline uint32_t g_frustumCulledCount = 0;
+    inline uint32_t g_occlusionCulledCount = 0;
+    inline bool g_automaticLods = true;
+    inline float g_lodPixelThreshold = 1.0f;
 
     inline void Init() {
         // nothing as of yet
     }
 
-    inline void Update(float deltaTime) {
-        // Clear global render item vectors
+    // Program in the top 16 bits, then material, then mesh, so items sharing state end up adjacent
+    inline uint64_t CreateRenderItemSortKey(uint32_t program, uint32_t material, uint32_t mesh) {
+        return ((uint64_t)(program & 0xFFFF) << 48) | ((uint64_t)(material & 0xFFFFFF) << 24) | (uint64_t)(mesh & 0xFFFFFF);
+    }
+
+    inline void SortRenderItems(std::vector<RenderItem>& renderItems, BlendingMode blendingMode) {
+        for (RenderItem& renderItem : renderItems) {
+            renderItem.sortKey = CreateRenderItemSortKey((uint32_t)blendingMode, (uint32_t)renderItem.materialIndex, (uint32_t)renderItem.meshIndex);
+        }
+        std::sort(renderItems.begin(), renderItems.end(), [](const RenderItem& a, const RenderItem& b) {
+            return a.sortKey < b.sortKey;
+        });
+    }
+
+    inline void AppendRenderItems(std::vector<RenderItem>& dst, const std::vector<RenderItem>& src, int gameObjectIndex) {
+        for (const RenderItem& renderItem : src) {
+            dst.push_back(renderItem);
+            dst.back().gameObjectIndex = gameObjectIndex;
+        }
+    }
+
+    inline void RebuildRenderLists() {
         g_renderItems.clear();
         g_renderItemsBlended.clear();
         g_renderItemsAlphaDiscarded.clear();
         g_renderItemsHairTopLayer.clear();
         g_renderItemsHairBottomLayer.clear();
 
-        // Update each GameObject and collect render items
+        for (int i = 0; i < g_gameObjects.size(); i++) {
+            GameObject& gameObject = g_gameObjects[i];
+            AppendRenderItems(g_renderItems, gameObject.GetRenderItems(), i);
+            AppendRenderItems(g_renderItemsBlended, gameObject.GetRenderItemsBlended(), i);
+            AppendRenderItems(g_renderItemsAlphaDiscarded, gameObject.GetRenderItemsAlphaDiscarded(), i);
+            AppendRenderItems(g_renderItemsHairTopLayer, gameObject.GetRenderItemsHairTopLayer(), i);
+            AppendRenderItems(g_renderItemsHairBottomLayer, gameObject.GetRenderItemsHairBottomLayer(), i);
+        }
+
+        // Blended items keep submission order
+        SortRenderItems(g_renderItems, BlendingMode::NONE);
+        SortRenderItems(g_renderItemsAlphaDiscarded, BlendingMode::ALPHA_DISCARDED);
+        SortRenderItems(g_renderItemsHairTopLayer, BlendingMode::HAIR_TOP_LAYER);
+        SortRenderItems(g_renderItemsHairBottomLayer, BlendingMode::HAIR_UNDER_LAYER);
+
+        // Remember where each object's items landed so transform changes can be patched in place
+        g_gameObjectRenderItems.resize(g_gameObjects.size());
+        for (std::vector<RenderItem*>& renderItemPtrs : g_gameObjectRenderItems) {
+            renderItemPtrs.clear();
+        }
+        for (std::vector<RenderItem>* renderItems : { &g_renderItems, &g_renderItemsBlended, &g_renderItemsAlphaDiscarded, &g_renderItemsHairTopLayer, &g_renderItemsHairBottomLayer }) {
+            for (RenderItem& renderItem : *renderItems) {
+                g_gameObjectRenderItems[renderItem.gameObjectIndex].push_back(&renderItem);
+            }
+        }
+    }
+
+    // The global lists persist between frames. A moved object has its matrix patched in place,
+    // anything that changes which lists an item lives in or its sort order triggers a rebuild.
+    inline void UpdateRenderLists() {
+        // Materials fall back to the default until their textures bake, so a finished bake re-resolves everything
+        if (g_renderListsMaterialRevision != AssetManager::GetMaterialRevision()) {
+            g_renderListsMaterialRevision = AssetManager::GetMaterialRevision();
+            for (GameObject& gameObject : g_gameObjects) {
+                gameObject.MarkRenderItemsDirty();
+            }
+        }
+
+        // World matrices of everything that moved, children follow their parents
+        TransformSystem::Update();
         for (GameObject& gameObject : g_gameObjects) {
-            gameObject.UpdateRenderItems();
+            if (TransformSystem::WorldMatrixChanged(gameObject.m_transformIndex)) {
+                gameObject.m_transformDirty = true;
+            }
+        }
+
+        bool rebuild = (g_gameObjectRenderItems.size() != g_gameObjects.size());
+        for (int i = 0; i < g_gameObjects.size(); i++) {
+            GameObject& gameObject = g_gameObjects[i];
+            if (gameObject.m_renderItemsDirty) {
+                gameObject.UpdateRenderItems();
+                rebuild = true;
+            }
+            else if (gameObject.m_transformDirty) {
+                gameObject.UpdateModelMatrix();
+                if (i < g_gameObjectRenderItems.size()) {
+                    for (RenderItem* renderItem : g_gameObjectRenderItems[i]) {
+                        renderItem->modelMatrix = gameObject.m_modelMatrix;
+                    }
+                }
+            }
+        }
+        if (rebuild) {
+            RebuildRenderLists();
+        }
+    }
+
+    inline void BenchmarkRenderLists();
+    inline void CullRenderItems();
+    inline void UpdateMaterialBindings();
+
+    inline void Update(float deltaTime) {
+        if (Input::KeyPressed(HELL_KEY_F3)) {
+            BenchmarkRenderLists();
+        }
+        if (Input::KeyPressed(HELL_KEY_F4)) {
+            g_frustumCulling = !g_frustumCulling;
+            std::cout << "Frustum culling: " << (g_frustumCulling ? "ON" : "OFF") << "\n";
+        }
+        if (Input::KeyPressed(HELL_KEY_F5)) {
+            g_occlusionCulling = !g_occlusionCulling;
+            g_occlusionDepthBuffer.valid = false;
+            std::cout << "Occlusion culling: " << (g_occlusionCulling ? "ON" : "OFF") << "\n";
+        }
+        if (Input::KeyPressed(HELL_KEY_F7)) {
+            g_automaticLods = !g_automaticLods;
+            std::cout << "Automatic LODs: " << (g_automaticLods ? "ON" : "OFF") << "\n";
+        }
+
+        UpdateMaterialBindings();
 
+        // Debug controls, edits mark the object dirty and the render lists catch up below
+        for (GameObject& gameObject : g_gameObjects) {
            if (gameObject.m_name == "Mermaid") {
                float amt = 0.5f;
                if (Input::KeyDown(HELL_KEY_LEFT)) {
                    gameObject.m_transform.rotation.y += deltaTime * amt;
+                   gameObject.MarkTransformDirty();
                        std::cout << gameObject.m_transform.rotation.y << "\n";
                }
                if (Input::KeyDown(HELL_KEY_RIGHT)) {
                    gameObject.m_transform.rotation.y -= deltaTime * amt;
+                   gameObject.MarkTransformDirty();
                        std::cout << gameObject.m_transform.rotation.y << "\n";
                }
            }
@@ -48,42 +179,158 @@ namespace Scene {
                 float ramt = 1.5f;
                 if (Input::KeyDown(HELL_KEY_U)) {
                     gameObject.m_transform.position.x += deltaTime * amt;
+                    gameObject.MarkTransformDirty();
                     std::cout << Util::Vec3ToString(gameObject.m_transform.position) << "\n";
                 }
                 if (Input::KeyDown(HELL_KEY_J)) {
                     gameObject.m_transform.position.x -= deltaTime * amt;
+                    gameObject.MarkTransformDirty();
                     std::cout << Util::Vec3ToString(gameObject.m_transform.position) << "\n";
                 }
                 if (Input::KeyDown(HELL_KEY_H)) {
                     gameObject.m_transform.position.z += deltaTime * amt;
+                    gameObject.MarkTransformDirty();
                     std::cout << Util::Vec3ToString(gameObject.m_transform.position) << "\n";
                 }
                 if (Input::KeyDown(HELL_KEY_K)) {
                     gameObject.m_transform.position.z -= deltaTime * amt;
+                    gameObject.MarkTransformDirty();
                     std::cout << Util::Vec3ToString(gameObject.m_transform.position) << "\n";
                 }
                 if (Input::KeyDown(HELL_KEY_Y)) {
                     gameObject.m_transform.rotation.y += deltaTime * ramt;
+                    gameObject.MarkTransformDirty();
                     std::cout << gameObject.m_transform.rotation.y << "\n";
                 }
                 if (Input::KeyDown(HELL_KEY_I)) {
                     gameObject.m_transform.rotation.y -= deltaTime * ramt;
+                    gameObject.MarkTransformDirty();
                     std::cout << gameObject.m_transform.rotation.y << "\n";
                 }
             }
+        }
+        UpdateRenderLists();
+        CullRenderItems();
+    }
+
+    // Coarsest LOD whose simplification error projects to less than g_lodPixelThreshold pixels,
+    // measured at the nearest point of the bounds so the switch happens before it can be seen
+    inline int SelectLod(OpenGLDetachedMesh* mesh, const glm::mat4& modelMatrix, const glm::vec3& center, const glm::vec3& extent, const CameraFrameData& camera) {
+        int lodCount = mesh->GetLodCount();
+        if (!g_automaticLods || lodCount <= 1) {
+            return 0;
+        }
+        float maxScale = std::max(glm::length(glm::vec3(modelMatrix[0])), std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+        float distance = std::max(glm::length(center - camera.viewPos) - glm::length(extent), 0.01f);
+        float pixelsPerUnit = camera.projection[1][1] * camera.viewportSize.y * 0.5f / distance;
+        int lodIndex = 0;
+        for (int i = 1; i < lodCount; i++) {
+            if (mesh->GetLodError(i) * maxScale * pixelsPerUnit > g_lodPixelThreshold) {
+                break;
+            }
+            lodIndex = i;
+        }
+        return lodIndex;
+    }
+
+    inline void CullRenderList(const std::vector<RenderItem>& renderItems, std::vector<RenderItem>& visibleRenderItems) {
+        visibleRenderItems.clear();
+        const CameraFrameData& camera = Camera::GetFrameData();
+        for (const RenderItem& renderItem : renderItems) {
+            OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(renderItem.meshIndex);
+            if (!mesh) {
+                continue;
+            }
+            glm::vec3 center, extent;
+            Culling::TransformAABB(renderItem.modelMatrix, mesh->aabbMin, mesh->aabbMax, center, extent);
+            if (g_frustumCulling && !Culling::AABBInFrustum(camera.frustumPlanes, center, extent)) {
+                g_frustumCulledCount++;
+                continue;
+            }
+            if (g_occlusionCulling && Culling::AABBOccluded(g_occlusionDepthBuffer, center, extent)) {
+                g_occlusionCulledCount++;
+                continue;
+            }
+            RenderItem& visibleRenderItem = visibleRenderItems.emplace_back(renderItem);
+            visibleRenderItem.lodIndex = SelectLod(mesh, renderItem.modelMatrix, center, extent, camera);
+        }
+    }
+
+    // Runs after the lists are current, sort order is preserved so the passes can still batch
+    inline void CullRenderItems() {
+        g_frustumCulledCount = 0;
+        g_occlusionCulledCount = 0;
+        CullRenderList(g_renderItems, g_visibleRenderItems);
+        CullRenderList(g_renderItemsBlended, g_visibleRenderItemsBlended);
+        CullRenderList(g_renderItemsAlphaDiscarded, g_visibleRenderItemsAlphaDiscarded);
+        CullRenderList(g_renderItemsHairTopLayer, g_visibleRenderItemsHairTopLayer);
+        CullRenderList(g_renderItemsHairBottomLayer, g_visibleRenderItemsHairBottomLayer);
+    }
+
+    inline std::string GetCullingStatsString() {
+        uint32_t total = (uint32_t)(g_renderItems.size() + g_renderItemsBlended.size() + g_renderItemsAlphaDiscarded.size() + g_renderItemsHairTopLayer.size() + g_renderItemsHairBottomLayer.size());
+        return "Culling: " + std::to_string(total - g_frustumCulledCount - g_occlusionCulledCount) + "/" + std::to_string(total) + " visible, frustum " + std::to_string(g_frustumCulledCount) + " occlusion " + std::to_string(g_occlusionCulledCount);
+    }
+
+    inline Culling::OcclusionDepthBuffer& GetOcclusionDepthBuffer() { return g_occlusionDepthBuffer; }
+    inline bool OcclusionCullingEnabled() { return g_occlusionCulling; }
+
+    inline void BenchmarkRenderLists() {
+        // CPU cost of keeping the render lists current at 10k GameObjects: rebuilding everything every frame
+        // as before, a frame where nothing changed, and a frame where 1% of the objects moved
+        const size_t gameObjectCount = 10000;
+        const int iterations = 20;
+        size_t originalCount = g_gameObjects.size();
+        uint32_t originalTransformCount = TransformSystem::GetCount();
+        if (originalCount == 0) {
+            return;
+        }
+        for (size_t i = originalCount; i < gameObjectCount; i++) {
+            GameObject gameObject = g_gameObjects[i % originalCount];
+            gameObject.m_transformIndex = TransformSystem::Create(gameObject.m_transform);
+            gameObject.SetPosition(glm::vec3((i % 100) * 2.0f, -1.0f, (i / 100) * 2.0f));
+            gameObject.MarkRenderItemsDirty();
+            g_gameObjects.push_back(gameObject);
+        }
+        UpdateRenderLists();
+        std::string suffix = " (" + std::to_string(g_gameObjects.size()) + " objects, " + std::to_string(g_renderItems.size() + g_renderItemsBlended.size()) + " items x " + std::to_string(iterations) + ")";
 
-            // Merge render items into global vectors
-            g_renderItems.insert(g_renderItems.end(), gameObject.GetRenderItems().begin(), gameObject.GetRenderItems().end());
-            g_renderItemsBlended.insert(g_renderItemsBlended.end(), gameObject.GetRenderItemsBlended().begin(), gameObject.GetRenderItemsBlended().end());
-            g_renderItemsAlphaDiscarded.insert(g_renderItemsAlphaDiscarded.end(), gameObject.GetRenderItemsAlphaDiscarded().begin(), gameObject.GetRenderItemsAlphaDiscarded().end());
-            g_renderItemsHairTopLayer.insert(g_renderItemsHairTopLayer.end(), gameObject.GetRenderItemsHairTopLayer().begin(), gameObject.GetRenderItemsHairTopLayer().end());
-            g_renderItemsHairBottomLayer.insert(g_renderItemsHairBottomLayer.end(), gameObject.GetRenderItemsHairBottomLayer().begin(), gameObject.GetRenderItemsHairBottomLayer().end());
+        {
+            Timer timer("Render lists full rebuild" + suffix);
+            for (int i = 0; i < iterations; i++) {
+                for (GameObject& gameObject : g_gameObjects) {
+                    gameObject.MarkRenderItemsDirty();
+                }
+                UpdateRenderLists();
+            }
+        }
+        {
+            Timer timer("Render lists unchanged" + suffix);
+            for (int i = 0; i < iterations; i++) {
+                UpdateRenderLists();
+            }
+        }
+        {
+            Timer timer("Render lists 1% moved" + suffix);
+            for (int i = 0; i < iterations; i++) {
+                // Only the benchmark copies move, the scene's own objects are left where they were
+                for (size_t j = originalCount; j < g_gameObjects.size(); j += 100) {
+                    g_gameObjects[j].m_transform.position.y += 0.001f;
+                    g_gameObjects[j].MarkTransformDirty();
+                }
+                UpdateRenderLists();
+            }
         }
+
+        g_gameObjects.resize(originalCount);
+        TransformSystem::Truncate(originalTransformCount);
+        UpdateRenderLists();
     }
 
 
     inline void CreateGameObject() {
-        g_gameObjects.emplace_back();
+        GameObject& gameObject = g_gameObjects.emplace_back();
+        gameObject.m_transformIndex = TransformSystem::Create(gameObject.m_transform);
     }
 
     inline GameObject* GetGameObjectByName(const std::string& name) {
@@ -95,36 +342,101 @@ namespace Scene {
         return nullptr;
     }
 
-    inline void SetMaterials() {
-        GameObject* room = GetGameObjectByName("Room");
-        if (room) {
-            room->SetMeshMaterialByMeshName("PlatformSide", "BathroomFloor");
-            room->SetMeshMaterialByMeshName("PlatformTop", "BathroomFloor");
-            room->SetMeshMaterialByMeshName("Floor", "BathroomFloor");
-            room->SetMeshMaterialByMeshName("Ceiling", "Ceiling2");
-            room->SetMeshMaterialByMeshName("WallZPos", "BathroomWall");
-            room->SetMeshMaterialByMeshName("WallZNeg", "BathroomWall");
-            room->SetMeshMaterialByMeshName("WallXPos", "BathroomWall");
-            room->SetMeshMaterialByMeshName("WallXNeg", "BathroomWall");
-        }
-
-        GameObject* mermaid = GetGameObjectByName("Mermaid");
-        if (mermaid) {
-            mermaid->SetMeshMaterialByMeshName("Rock", "Rock");
-            mermaid->SetMeshMaterialByMeshName("BoobTube", "BoobTube");
-            mermaid->SetMeshMaterialByMeshName("Face", "MermaidFace");
-            mermaid->SetMeshMaterialByMeshName("Body", "MermaidBody");
-            mermaid->SetMeshMaterialByMeshName("Arms", "MermaidArms");
-            mermaid->SetMeshMaterialByMeshName("HairInner", "MermaidHair");
-            mermaid->SetMeshMaterialByMeshName("HairOutta", "MermaidHair");
-            mermaid->SetMeshMaterialByMeshName("HairScalp", "MermaidScalp");
-            mermaid->SetMeshMaterialByMeshName("EyeLeft", "MermaidEye");
-            mermaid->SetMeshMaterialByMeshName("EyeRight", "MermaidEye");
-            mermaid->SetMeshMaterialByMeshName("Tail", "MermaidTail");
-            mermaid->SetMeshMaterialByMeshName("TailFin", "MermaidTail");
-            mermaid->SetMeshMaterialByMeshName("EyelashUpper_HP", "MermaidLashes");
-            mermaid->SetMeshMaterialByMeshName("EyelashLower_HP", "MermaidLashes");
-            mermaid->SetMeshMaterialByMeshName("Nails", "Nails");
+    struct MaterialBinding {
+        const char* gameObjectName;
+        const char* meshName;
+        const char* materialName;
+    };
+
+    struct ResolvedMaterialBinding {
+        int gameObjectIndex;
+        int meshSlot;
+        int materialIndex;
+    };
+
+    inline const std::vector<MaterialBinding> g_materialBindings = {
+        { "Room", "PlatformSide", "BathroomFloor" },
+        { "Room", "PlatformTop", "BathroomFloor" },
+        { "Room", "Floor", "BathroomFloor" },
+        { "Room", "Ceiling", "Ceiling2" },
+        { "Room", "WallZPos", "BathroomWall" },
+        { "Room", "WallZNeg", "BathroomWall" },
+        { "Room", "WallXPos", "BathroomWall" },
+        { "Room", "WallXNeg", "BathroomWall" },
+        { "Mermaid", "Rock", "Rock" },
+        { "Mermaid", "BoobTube", "BoobTube" },
+        { "Mermaid", "Face", "MermaidFace" },
+        { "Mermaid", "Body", "MermaidBody" },
+        { "Mermaid", "Arms", "MermaidArms" },
+        { "Mermaid", "HairInner", "MermaidHair" },
+        { "Mermaid", "HairOutta", "MermaidHair" },
+        { "Mermaid", "HairScalp", "MermaidScalp" },
+        { "Mermaid", "EyeLeft", "MermaidEye" },
+        { "Mermaid", "EyeRight", "MermaidEye" },
+        { "Mermaid", "Tail", "MermaidTail" },
+        { "Mermaid", "TailFin", "MermaidTail" },
+        { "Mermaid", "EyelashUpper_HP", "MermaidLashes" },
+        { "Mermaid", "EyelashLower_HP", "MermaidLashes" },
+        { "Mermaid", "Nails", "Nails" },
+    };
+    inline std::vector<ResolvedMaterialBinding> g_resolvedMaterialBindings;
+    inline uint32_t g_materialBindingsRevision = 0xFFFFFFFF;
+
+    inline int GetGameObjectIndexByName(const std::string& name) {
+        for (int i = 0; i < g_gameObjects.size(); i++) {
+            if (g_gameObjects[i].m_name == name) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Turns the name based table into object, mesh slot and material indices. Bindings whose object is
+    // not in the scene are dropped silently, missing meshes or materials are reported once here.
+    inline void ResolveMaterialBindings() {
+        g_resolvedMaterialBindings.clear();
+        for (const MaterialBinding& binding : g_materialBindings) {
+            int gameObjectIndex = GetGameObjectIndexByName(binding.gameObjectName);
+            if (gameObjectIndex == -1) {
+                continue;
+            }
+            Model* model = g_gameObjects[gameObjectIndex].m_model;
+            int materialIndex = AssetManager::GetMaterialIndex(binding.materialName);
+            if (!model || materialIndex == -1) {
+                continue;
+            }
+            int meshSlot = -1;
+            for (int i = 0; i < model->GetMeshCount(); i++) {
+                OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(model->GetMeshIndices()[i]);
+                if (mesh && mesh->GetName() == binding.meshName) {
+                    meshSlot = i;
+                    break;
+                }
+            }
+            if (meshSlot == -1) {
+                std::cout << "Scene::ResolveMaterialBindings() failed because mesh '" << binding.meshName << "' was not found in '" << binding.gameObjectName << "'\n";
+                continue;
+            }
+            g_resolvedMaterialBindings.push_back({ gameObjectIndex, meshSlot, materialIndex });
+        }
+        g_materialBindingsRevision = AssetManager::GetMaterialRevision();
+    }
+
+    inline void ApplyMaterialBindings() {
+        for (const ResolvedMaterialBinding& binding : g_resolvedMaterialBindings) {
+            GameObject& gameObject = g_gameObjects[binding.gameObjectIndex];
+            if (gameObject.m_meshMaterialIndices[binding.meshSlot] != binding.materialIndex) {
+                gameObject.m_meshMaterialIndices[binding.meshSlot] = binding.materialIndex;
+                gameObject.MarkRenderItemsDirty();
+            }
+        }
+    }
+
+    // Free on most frames, the table is only walked again once a texture bake or material completes
+    inline void UpdateMaterialBindings() {
+        if (g_materialBindingsRevision != AssetManager::GetMaterialRevision()) {
+            ResolveMaterialBindings();
+            ApplyMaterialBindings();
         }
     }
 
@@ -136,21 +448,6 @@ namespace Scene {
         mermaid->SetPosition(glm::vec3(0.0, -1.0f, 0.0f));
         mermaid->SetRotationY(3.14f * 1.7f);
         mermaid->SetModel("Mermaid");
-        mermaid->SetMeshMaterialByMeshName("Rock", "Rock");
-        mermaid->SetMeshMaterialByMeshName("BoobTube", "BoobTube");
-        mermaid->SetMeshMaterialByMeshName("Face", "MermaidFace");
-        mermaid->SetMeshMaterialByMeshName("Body", "MermaidBody");
-        mermaid->SetMeshMaterialByMeshName("Arms", "MermaidArms");
-        mermaid->SetMeshMaterialByMeshName("HairInner", "MermaidHair");
-        mermaid->SetMeshMaterialByMeshName("HairOutta", "MermaidHair");
-        mermaid->SetMeshMaterialByMeshName("HairScalp", "MermaidScalp");
-        mermaid->SetMeshMaterialByMeshName("EyeLeft", "MermaidEye");
-        mermaid->SetMeshMaterialByMeshName("EyeRight", "MermaidEye");
-        mermaid->SetMeshMaterialByMeshName("Tail", "MermaidTail");
-        mermaid->SetMeshMaterialByMeshName("TailFin", "MermaidTail");
-        mermaid->SetMeshMaterialByMeshName("EyelashUpper_HP", "MermaidLashes");
-        mermaid->SetMeshMaterialByMeshName("EyelashLower_HP", "MermaidLashes");
-        mermaid->SetMeshMaterialByMeshName("Nails", "Nails");
         mermaid->SetMeshBlendingMode("EyelashUpper_HP", BlendingMode::BLENDED);
         mermaid->SetMeshBlendingMode("EyelashLower_HP", BlendingMode::BLENDED);
         mermaid->SetMeshBlendingMode("HairScalp", BlendingMode::BLENDED);
@@ -164,13 +461,17 @@ namespace Scene {
         shark->SetModel("Shark2");
         shark->SetPosition(glm::vec3(-2.20, -3.25, 4.87));
         shark->m_meshMaterialIndices[0] = AssetManager::GetMaterialIndex("Shark");
+        shark->MarkRenderItemsDirty();
         shark->SetRotationY(-5.08011);
         shark->SetName("Shark");
+
+        ResolveMaterialBindings();
+        ApplyMaterialBindings();
     }
 
-    inline std::vector<RenderItem>& GetRenderItems() { return g_renderItems; }
-    inline std::vector<RenderItem>& GetRenderItemsBlended() { return g_renderItemsBlended; }
-    inline std::vector<RenderItem>& GetRenderItemsAlphaDiscarded() { return g_renderItemsAlphaDiscarded; }
-    inline std::vector<RenderItem>& GetRenderItemsHairTopLayer() { return g_renderItemsHairTopLayer; }
-    inline std::vector<RenderItem>& GetRenderItemsHairBottomLayer() { return g_renderItemsHairBottomLayer; }
+    inline std::vector<RenderItem>& GetRenderItems() { return g_visibleRenderItems; }
+    inline std::vector<RenderItem>& GetRenderItemsBlended() { return g_visibleRenderItemsBlended; }
+    inline std::vector<RenderItem>& GetRenderItemsAlphaDiscarded() { return g_visibleRenderItemsAlphaDiscarded; }
+    inline std::vector<RenderItem>& GetRenderItemsHairTopLayer() { return g_visibleRenderItemsHairTopLayer; }
+    inline std::vector<RenderItem>& GetRenderItemsHairBottomLayer() { return g_visibleRenderItemsHairBottomLayer; }
 }
\ No newline at end of file
@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "HellTypes.h"
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define TRANSFORM_SYSTEM_SSE 1
+#else
+#define TRANSFORM_SYSTEM_SSE 0
+#endif
+
+// Transforms stored structure of arrays with their local and world matrices cached. Setters only flag an entry,
+// Update() recomputes the flagged entries in one batch, parents before children, and records which world matrices moved.
+namespace TransformSystem {
+
+    constexpr uint32_t NO_PARENT = 0xFFFFFFFF;
+    constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    struct Storage {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> rotations;
+        std::vector<glm::vec3> scales;
+        std::vector<uint32_t> parents;
+        std::vector<glm::mat4> localMatrices;
+        std::vector<glm::mat4> worldMatrices;
+        std::vector<uint8_t> localDirty;
+        std::vector<uint8_t> worldChanged;
+        std::vector<uint32_t> updateOrder;  // Sorted by hierarchy depth so parents are always resolved first
+        bool hierarchyDirty = true;
+    };
+
+    inline Storage g_storage;
+
+    inline uint32_t Create(const Transform& transform = Transform()) {
+        Storage& s = g_storage;
+        s.positions.push_back(transform.position);
+        s.rotations.push_back(transform.rotation);
+        s.scales.push_back(transform.scale);
+        s.parents.push_back(NO_PARENT);
+        s.localMatrices.push_back(glm::mat4(1));
+        s.worldMatrices.push_back(glm::mat4(1));
+        s.localDirty.push_back(1);
+        s.worldChanged.push_back(0);
+        s.hierarchyDirty = true;
+        return (uint32_t)(s.positions.size() - 1);
+    }
+
+    inline uint32_t GetCount() {
+        return (uint32_t)g_storage.positions.size();
+    }
+
+    // Drops every entry from count onwards, for callers that created temporary transforms
+    inline void Truncate(uint32_t count) {
+        Storage& s = g_storage;
+        if (count >= s.positions.size()) {
+            return;
+        }
+        s.positions.resize(count);
+        s.rotations.resize(count);
+        s.scales.resize(count);
+        s.parents.resize(count);
+        s.localMatrices.resize(count);
+        s.worldMatrices.resize(count);
+        s.localDirty.resize(count);
+        s.worldChanged.resize(count);
+        for (uint32_t& parent : s.parents) {
+            if (parent != NO_PARENT && parent >= count) {
+                parent = NO_PARENT;
+            }
+        }
+        s.hierarchyDirty = true;
+    }
+
+    inline bool IsValid(uint32_t index) {
+        return index < g_storage.positions.size();
+    }
+
+    inline void SetLocalTransform(uint32_t index, const Transform& transform) {
+        if (!IsValid(index)) return;
+        g_storage.positions[index] = transform.position;
+        g_storage.rotations[index] = transform.rotation;
+        g_storage.scales[index] = transform.scale;
+        g_storage.localDirty[index] = 1;
+    }
+
+    inline void SetPosition(uint32_t index, const glm::vec3& position) {
+        if (!IsValid(index)) return;
+        g_storage.positions[index] = position;
+        g_storage.localDirty[index] = 1;
+    }
+
+    inline void SetRotation(uint32_t index, const glm::vec3& rotation) {
+        if (!IsValid(index)) return;
+        g_storage.rotations[index] = rotation;
+        g_storage.localDirty[index] = 1;
+    }
+
+    inline void SetScale(uint32_t index, const glm::vec3& scale) {
+        if (!IsValid(index)) return;
+        g_storage.scales[index] = scale;
+        g_storage.localDirty[index] = 1;
+    }
+
+    // The child's local transform is interpreted relative to the parent from the next Update() on
+    inline void SetParent(uint32_t child, uint32_t parent) {
+        if (!IsValid(child) || (parent != NO_PARENT && !IsValid(parent))) {
+            std::cout << "TransformSystem::SetParent() failed because index " << child << " or " << parent << " is out of range\n";
+            return;
+        }
+        for (uint32_t ancestor = parent; ancestor != NO_PARENT; ancestor = g_storage.parents[ancestor]) {
+            if (ancestor == child) {
+                std::cout << "TransformSystem::SetParent() failed because " << parent << " is a descendant of " << child << "\n";
+                return;
+            }
+        }
+        g_storage.parents[child] = parent;
+        g_storage.localDirty[child] = 1;
+        g_storage.hierarchyDirty = true;
+    }
+
+    inline uint32_t GetParent(uint32_t index) {
+        return IsValid(index) ? g_storage.parents[index] : NO_PARENT;
+    }
+
+    inline const glm::mat4& GetWorldMatrix(uint32_t index) {
+        static const glm::mat4 identity = glm::mat4(1);
+        return IsValid(index) ? g_storage.worldMatrices[index] : identity;
+    }
+
+    inline const glm::mat4& GetLocalMatrix(uint32_t index) {
+        static const glm::mat4 identity = glm::mat4(1);
+        return IsValid(index) ? g_storage.localMatrices[index] : identity;
+    }
+
+    // True if the world matrix was recomputed by the last Update(), either directly or through a parent
+    inline bool WorldMatrixChanged(uint32_t index) {
+        return IsValid(index) && g_storage.worldChanged[index];
+    }
+
+    // Translation * rotation * scale written straight into the columns, no intermediate matrix products.
+    // The Euler to quaternion step is scalar, each rotation column is then two multiply adds over shuffled lanes
+    inline glm::mat4 ComposeLocalMatrix(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+        glm::quat q = glm::quat(rotation);
+        glm::mat4 m;
+#if TRANSFORM_SYSTEM_SSE
+        __m128 v = _mm_setr_ps(q.x, q.y, q.z, q.w);
+        __m128 v2 = _mm_add_ps(v, v);
+        // Column 0 = (1 - 2yy - 2zz, 2xy + 2wz, 2xz - 2wy), lane 3 is zeroed by the sign masks
+        __m128 c0 = _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 0, 1)), _mm_setr_ps(-1, 1, 1, 0)), _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 2, 1, 1)));
+        c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 2)), _mm_setr_ps(-1, 1, -1, 0)), _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 1, 2, 2))));
+        c0 = _mm_add_ps(c0, _mm_setr_ps(1, 0, 0, 0));
+        // Column 1 = (2xy - 2wz, 1 - 2xx - 2zz, 2yz + 2wx)
+        __m128 c1 = _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 1)), _mm_setr_ps(1, -1, 1, 0)), _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 2, 0, 0)));
+        c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 2, 3)), _mm_setr_ps(-1, -1, 1, 0)), _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 0, 2, 2))));
+        c1 = _mm_add_ps(c1, _mm_setr_ps(0, 1, 0, 0));
+        // Column 2 = (2xz + 2wy, 2yz - 2wx, 1 - 2xx - 2yy)
+        __m128 c2 = _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 2)), _mm_setr_ps(1, 1, -1, 0)), _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 0, 1, 0)));
+        c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 3, 3)), _mm_setr_ps(1, -1, -1, 0)), _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 1, 0, 1))));
+        c2 = _mm_add_ps(c2, _mm_setr_ps(0, 0, 1, 0));
+        _mm_storeu_ps(&m[0][0], _mm_mul_ps(c0, _mm_set1_ps(scale.x)));
+        _mm_storeu_ps(&m[1][0], _mm_mul_ps(c1, _mm_set1_ps(scale.y)));
+        _mm_storeu_ps(&m[2][0], _mm_mul_ps(c2, _mm_set1_ps(scale.z)));
+#else
+        glm::mat3 r = glm::mat3_cast(q);
+        m[0] = glm::vec4(r[0] * scale.x, 0.0f);
+        m[1] = glm::vec4(r[1] * scale.y, 0.0f);
+        m[2] = glm::vec4(r[2] * scale.z, 0.0f);
+#endif
+        m[3] = glm::vec4(position, 1.0f);
+        return m;
+    }
+
+    inline void MultiplyMat4(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+#if TRANSFORM_SYSTEM_SSE
+        __m128 a0 = _mm_loadu_ps(&a[0][0]);
+        __m128 a1 = _mm_loadu_ps(&a[1][0]);
+        __m128 a2 = _mm_loadu_ps(&a[2][0]);
+        __m128 a3 = _mm_loadu_ps(&a[3][0]);
+        for (int i = 0; i < 4; i++) {
+            __m128 column = _mm_mul_ps(a0, _mm_set1_ps(b[i][0]));
+            column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(b[i][1])));
+            column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(b[i][2])));
+            column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(b[i][3])));
+            _mm_storeu_ps(&out[i][0], column);
+        }
+#else
+        out = a * b;
+#endif
+    }
+
+    inline void RebuildUpdateOrder() {
+        Storage& s = g_storage;
+        std::vector<uint32_t> depths(s.parents.size(), 0);
+        for (uint32_t i = 0; i < s.parents.size(); i++) {
+            for (uint32_t ancestor = s.parents[i]; ancestor != NO_PARENT; ancestor = s.parents[ancestor]) {
+                depths[i]++;
+            }
+        }
+        s.updateOrder.resize(s.parents.size());
+        for (uint32_t i = 0; i < s.updateOrder.size(); i++) {
+            s.updateOrder[i] = i;
+        }
+        std::stable_sort(s.updateOrder.begin(), s.updateOrder.end(), [&depths](uint32_t a, uint32_t b) {
+            return depths[a] < depths[b];
+        });
+        s.hierarchyDirty = false;
+    }
+
+    inline void Update() {
+        Storage& s = g_storage;
+        if (s.hierarchyDirty) {
+            RebuildUpdateOrder();
+        }
+        std::fill(s.worldChanged.begin(), s.worldChanged.end(), 0);
+
+        // Local matrices of flagged entries, a linear walk over contiguous arrays
+        for (size_t i = 0; i < s.positions.size(); i++) {
+            if (s.localDirty[i]) {
+                s.localMatrices[i] = ComposeLocalMatrix(s.positions[i], s.rotations[i], s.scales[i]);
+            }
+        }
+
+        // World matrices, an entry is recomputed if it or any ancestor changed
+        for (uint32_t i : s.updateOrder) {
+            uint32_t parent = s.parents[i];
+            bool parentChanged = (parent != NO_PARENT && s.worldChanged[parent]);
+            if (!s.localDirty[i] && !parentChanged) {
+                continue;
+            }
+            if (parent == NO_PARENT) {
+                s.worldMatrices[i] = s.localMatrices[i];
+            }
+            else {
+                MultiplyMat4(s.worldMatrices[parent], s.localMatrices[i], s.worldMatrices[i]);
+            }
+            s.worldChanged[i] = 1;
+        }
+        std::fill(s.localDirty.begin(), s.localDirty.end(), 0);
+    }
+}
@@ -5,18 +5,34 @@
 #include <cstdint>
 #include <chrono>
 #include "../Util.hpp"
+#include "../Tools/MeshTools.h"
 
 #define PRINT_MODEL_HEADERS_ON_READ 0
 #define PRINT_MODEL_HEADERS_ON_WRITE 0
 #define PRINT_MESH_HEADERS_ON_READ 0
 #define PRINT_MESH_HEADERS_ON_WRITE 0
+#define PRINT_MESH_VERTEX_CACHE_STATS_ON_READ 1
 
 /*
 █▄ ▄█ █▀█ █▀▄ █▀▀ █   █▀▀
 █ █ █ █ █ █ █ █▀▀ █   ▀▀█
 ▀   ▀ ▀▀▀ ▀▀  ▀▀▀ ▀▀▀ ▀▀▀ */
 
-void File::ExportModel(const ModelData& modelData) {
+void File::ExportModel(ModelData& modelData) {
+    // Offline processing, runs once per export
+    for (MeshData& meshData : modelData.meshes) {
+        // Snap to the quantization grid first so everything derived below matches what gets loaded
+        if (MODEL_EXPORT_VERTEX_FORMAT == VertexFormat::QUANTIZED) {
+            meshData.vertices = MeshTools::DequantizeVertices(MeshTools::QuantizeVertices(meshData.vertices, meshData.aabbMin, meshData.aabbMax), meshData.aabbMin, meshData.aabbMax);
+        }
+        MeshTools::GenerateLods(meshData);
+        MeshTools::OptimizeMesh(meshData);
+        meshData.meshlets.clear();
+        if (meshData.indices.size() / 3 >= MESHLET_MIN_MESH_TRIANGLES) {
+            meshData.meshlets = MeshTools::BuildMeshlets(meshData.vertices, meshData.indices);
+        }
+    }
+
     std::string outputPath = "res/models/" + modelData.name + ".model";
     std::ofstream file(outputPath, std::ios::binary);
     if (!file.is_open()) {
@@ -24,7 +40,7 @@ void File::ExportModel(const ModelData& modelData) {
         return;
     }
     ModelHeader modelHeader;
-    modelHeader.version = 1;
+    modelHeader.version = MODEL_FILE_VERSION;
     modelHeader.meshCount = modelData.meshCount;
     modelHeader.nameLength = modelData.name.size();
     modelHeader.timestamp = modelData.timestamp;
@@ -45,16 +61,35 @@ void File::ExportModel(const ModelData& modelData) {
         meshHeader.nameLength = (uint32_t)meshData.name.size();
         meshHeader.vertexCount = (uint32_t)meshData.vertices.size();
         meshHeader.indexCount = (uint32_t)meshData.indices.size();
+        meshHeader.vertexFormat = (uint32_t)MODEL_EXPORT_VERTEX_FORMAT;
         meshHeader.aabbMin = meshData.aabbMin;
         meshHeader.aabbMax = meshData.aabbMax;
         file.write((char*)&meshHeader.nameLength, sizeof(meshHeader.nameLength));
         file.write((char*)&meshHeader.vertexCount, sizeof(meshHeader.vertexCount));
         file.write((char*)&meshHeader.indexCount, sizeof(meshHeader.indexCount));
+        file.write((char*)&meshHeader.vertexFormat, sizeof(meshHeader.vertexFormat));
         file.write(meshData.name.data(), meshHeader.nameLength);
         file.write(reinterpret_cast<const char*>(&meshHeader.aabbMin), sizeof(glm::vec3));
         file.write(reinterpret_cast<const char*>(&meshHeader.aabbMax), sizeof(glm::vec3));
-        file.write(reinterpret_cast<const char*>(meshData.vertices.data()), meshData.vertices.size() * sizeof(Vertex));
+        if (meshHeader.vertexFormat == (uint32_t)VertexFormat::QUANTIZED) {
+            std::vector<CompactVertex> compactVertices = MeshTools::QuantizeVertices(meshData.vertices, meshData.aabbMin, meshData.aabbMax);
+            file.write(reinterpret_cast<const char*>(compactVertices.data()), compactVertices.size() * sizeof(CompactVertex));
+        }
+        else {
+            file.write(reinterpret_cast<const char*>(meshData.vertices.data()), meshData.vertices.size() * sizeof(Vertex));
+        }
         file.write(reinterpret_cast<const char*>(meshData.indices.data()), meshData.indices.size() * sizeof(uint32_t));
+        uint32_t lodCount = (uint32_t)meshData.lods.size();
+        file.write((char*)&lodCount, sizeof(lodCount));
+        for (const MeshLod& lod : meshData.lods) {
+            uint32_t lodIndexCount = (uint32_t)lod.indices.size();
+            file.write((char*)&lodIndexCount, sizeof(lodIndexCount));
+            file.write((char*)&lod.error, sizeof(lod.error));
+            file.write(reinterpret_cast<const char*>(lod.indices.data()), lod.indices.size() * sizeof(uint32_t));
+        }
+        uint32_t meshletCount = (uint32_t)meshData.meshlets.size();
+        file.write((char*)&meshletCount, sizeof(meshletCount));
+        file.write(reinterpret_cast<const char*>(meshData.meshlets.data()), meshData.meshlets.size() * sizeof(Meshlet));
 #if PRINT_MESH_HEADERS_ON_WRITE
         PrintMeshHeader(meshHeader, "Wrote mesh: " + meshData.name);
 #endif
@@ -109,6 +144,9 @@ ModelData File::ImportModel(const std::string& filepath) {
         file.read((char*)&meshHeader.nameLength, sizeof(meshHeader.nameLength));
         file.read((char*)&meshHeader.vertexCount, sizeof(meshHeader.vertexCount));
         file.read((char*)&meshHeader.indexCount, sizeof(meshHeader.indexCount));
+        if (modelHeader.version >= 5) {
+            file.read((char*)&meshHeader.vertexFormat, sizeof(meshHeader.vertexFormat));
+        }
         std::string meshName(meshHeader.nameLength, '\0');
         file.read(&meshName[0], meshHeader.nameLength);
         file.read(reinterpret_cast<char*>(&meshHeader.aabbMin), sizeof(glm::vec3));
@@ -121,10 +159,39 @@ ModelData File::ImportModel(const std::string& filepath) {
         meshData.indices.resize(meshData.indexCount);
         meshData.aabbMin = meshHeader.aabbMin;
         meshData.aabbMax = meshHeader.aabbMax;
-        file.read(reinterpret_cast<char*>(meshData.vertices.data()), meshHeader.vertexCount * sizeof(Vertex));
+        if (meshHeader.vertexFormat == (uint32_t)VertexFormat::QUANTIZED) {
+            std::vector<CompactVertex> compactVertices(meshHeader.vertexCount);
+            file.read(reinterpret_cast<char*>(compactVertices.data()), meshHeader.vertexCount * sizeof(CompactVertex));
+            meshData.vertices = MeshTools::DequantizeVertices(compactVertices, meshData.aabbMin, meshData.aabbMax);
+        }
+        else {
+            file.read(reinterpret_cast<char*>(meshData.vertices.data()), meshHeader.vertexCount * sizeof(Vertex));
+        }
         file.read(reinterpret_cast<char*>(meshData.indices.data()), meshHeader.indexCount * sizeof(uint32_t));
+        if (modelHeader.version >= 2) {
+            uint32_t lodCount = 0;
+            file.read((char*)&lodCount, sizeof(lodCount));
+            meshData.lods.resize(lodCount);
+            for (MeshLod& lod : meshData.lods) {
+                uint32_t lodIndexCount = 0;
+                file.read((char*)&lodIndexCount, sizeof(lodIndexCount));
+                file.read((char*)&lod.error, sizeof(lod.error));
+                lod.indices.resize(lodIndexCount);
+                file.read(reinterpret_cast<char*>(lod.indices.data()), lodIndexCount * sizeof(uint32_t));
+            }
+        }
+        if (modelHeader.version >= 4) {
+            uint32_t meshletCount = 0;
+            file.read((char*)&meshletCount, sizeof(meshletCount));
+            meshData.meshlets.resize(meshletCount);
+            file.read(reinterpret_cast<char*>(meshData.meshlets.data()), meshletCount * sizeof(Meshlet));
+        }
 #if PRINT_MESH_HEADERS_ON_READ
         PrintMeshHeader(meshHeader, "Read mesh: " + meshData.name);
+#endif
+#if PRINT_MESH_VERTEX_CACHE_STATS_ON_READ
+        VertexCacheStats vertexCacheStats = MeshTools::AnalyzeVertexCache(meshData.indices, meshData.vertices.size());
+        std::cout << " " << meshData.name << " ACMR: " << vertexCacheStats.acmr << " ATVR: " << vertexCacheStats.atvr << "\n";
 #endif
     }
     file.close();
@@ -205,6 +272,7 @@ void File::PrintMeshHeader(MeshHeader header, const std::string& identifier) {
     std::cout << " Name Length: " << header.nameLength << "\n";
     std::cout << " Vertex Count: " << header.vertexCount << "\n";
     std::cout << " Index Count: " << header.indexCount << "\n";
+    std::cout << " Vertex Format: " << (header.vertexFormat == (uint32_t)VertexFormat::QUANTIZED ? "Quantized" : "Float32") << "\n";
     std::cout << " AABB min: " << Util::Vec3ToString(header.aabbMin) << "\n";
     std::cout << " AABB max: " << Util::Vec3ToString(header.aabbMax) << "\n\n";
 }
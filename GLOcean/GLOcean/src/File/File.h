@@ -4,7 +4,7 @@
 
 namespace File {
     // Models
-    void ExportModel(const ModelData& modelData);
+    void ExportModel(ModelData& modelData);
     ModelData ImportModel(const std::string& filepath);
     ModelHeader ReadModelHeader(const std::string& filepath);
     
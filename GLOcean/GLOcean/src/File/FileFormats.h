@@ -1,6 +1,12 @@
 #pragma once
 #include "HellTypes.h"
 
+// Bump when the layout changes, older files are re-exported on load
+constexpr uint32_t MODEL_FILE_VERSION = 5;
+
+// Vertex stream written by the exporter, either loads
+constexpr VertexFormat MODEL_EXPORT_VERTEX_FORMAT = VertexFormat::QUANTIZED;
+
 struct ModelHeader {
     char fileSignature[11] = "HELL_MODEL";
     uint32_t version;
@@ -15,10 +21,28 @@ struct MeshHeader {
     uint32_t nameLength;
     uint32_t vertexCount;
     uint32_t indexCount;
+    uint32_t vertexFormat = (uint32_t)VertexFormat::FLOAT32;
     glm::vec3 aabbMin;
     glm::vec3 aabbMax;
 };
 
+// Simplified index list sharing the vertices of its mesh. Error is in model units
+struct MeshLod {
+    std::vector<uint32_t> indices;
+    float error = 0.0f;
+};
+
+// Contiguous run of a mesh's index list, small enough to be culled on its own. Every triangle faces away from
+// a viewer at viewPos when dot(center - viewPos, coneAxis) >= coneCutoff * length(center - viewPos) + radius
+struct Meshlet {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    glm::vec3 center;
+    float radius;
+    glm::vec3 coneAxis;
+    float coneCutoff;
+};
+
 struct MeshData {
     std::string name;
     std::vector<Vertex> vertices;
@@ -27,6 +51,8 @@ struct MeshData {
     int indexCount;
     glm::vec3 aabbMin = glm::vec3(std::numeric_limits<float>::max());
     glm::vec3 aabbMax = glm::vec3(-std::numeric_limits<float>::max());
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
 };
 
 struct ModelData {
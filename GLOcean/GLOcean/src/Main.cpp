@@ -32,7 +32,6 @@ void Update() {
     deltaTime = static_cast<float>(currentTime - lastTime);
     lastTime = currentTime;
     OpenGLBackend::UpdateTextureBaking();
-    Scene::SetMaterials();
     AssetManager::Update();
     TextBlitter::Update();
     Input::Update();
@@ -21,6 +21,10 @@ namespace Ocean {
     const float g_meshSubdivisionFactor = 32.0f;     // Number of mesh subdivisions per FFT grid cell; controls mesh density 
     const float g_modelMatrixScale = g_oceanMeshToGridRatio / g_baseFftResolution; // was g_fftResolution.x;
     const float g_oceanOriginY = -0.65;
+    const float g_patchWorldSizes[2] = { 8.0f, 13.123f }; // Must match OCEAN_PATCH_SIZE_BAND* in ocean.glsl
+    const int g_normalMipCount = 5;                  // Levels built by GL_ocean_update_textures.comp, must match OCEAN_NORMAL_MIP_COUNT in ocean.glsl
+    const int g_clipmapLevelCount = 9;               // Must match OCEAN_CLIPMAP_LEVEL_COUNT in ocean.glsl
+    const int g_clipmapResolution = 256;             // Must match OCEAN_CLIPMAP_RESOLUTION in ocean.glsl
 
     //glm::vec2 g_mWindDir = glm::normalize(glm::vec2(1.0f, 0.0f));
     float g_windSpeed = 75.0f;
@@ -161,6 +165,22 @@ namespace Ocean {
         return g_oceanOriginY;
     }
 
+    const int GetClipmapLevelCount() {
+        return g_clipmapLevelCount;
+    }
+
+    const int GetClipmapResolution() {
+        return g_clipmapResolution;
+    }
+
+    const float GetPatchWorldSize(int bandIndex) {
+        return g_patchWorldSizes[bandIndex];
+    }
+
+    const int GetNormalMipCount() {
+        return g_normalMipCount;
+    }
+
     const glm::uvec2 GetBaseFFTResolution() {
         return glm::uvec2(g_baseFftResolution);
     }
@@ -34,6 +34,10 @@ namespace Ocean {
     const float GetMeshSubdivisionFactor();
     const float GetModelMatrixScale();
     const float GetOceanOriginY();
+    const int GetNormalMipCount();
+    const float GetPatchWorldSize(int bandIndex);
+    const int GetClipmapLevelCount();
+    const int GetClipmapResolution();
     const glm::uvec2 GetBaseFFTResolution();
     const glm::vec2 GetPatchSimSize(int bandIndex);
     const glm::uvec2 GetTesslationMeshSize();
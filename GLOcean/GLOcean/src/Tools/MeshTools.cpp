@@ -0,0 +1,732 @@
+#include "MeshTools.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace MeshTools {
+
+    // Symmetric 4x4 plane quadric, a2 ab ac ad b2 bc bd c2 cd d2, plus the accumulated area weight
+    struct Quadric {
+        double q[10] = {};
+        double weight = 0.0;
+
+        void AddPlane(double a, double b, double c, double d, double w) {
+            q[0] += w * a * a; q[1] += w * a * b; q[2] += w * a * c; q[3] += w * a * d;
+            q[4] += w * b * b; q[5] += w * b * c; q[6] += w * b * d;
+            q[7] += w * c * c; q[8] += w * c * d;
+            q[9] += w * d * d;
+            weight += w;
+        }
+
+        void Add(const Quadric& other) {
+            for (int i = 0; i < 10; i++) {
+                q[i] += other.q[i];
+            }
+            weight += other.weight;
+        }
+
+        double Evaluate(const glm::vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            double result = q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+                          + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+                          + q[7] * z * z + 2 * q[8] * z
+                          + q[9];
+            return std::max(result, 0.0);
+        }
+    };
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+    uint64_t EdgeKey(uint32_t a, uint32_t b) {
+        return ((uint64_t)a << 32) | b;
+    }
+
+    // Seam vertices share a position with another vertex, border vertices sit on an edge used by one triangle.
+    // Both are locked so UVs, normals and silhouettes survive simplification.
+    std::vector<uint8_t> FindLockedVertices(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        std::vector<uint8_t> locked(vertices.size(), 0);
+
+        struct PositionHash {
+            size_t operator()(const glm::vec3& p) const {
+                uint32_t bits[3];
+                std::memcpy(bits, &p, sizeof(bits));
+                return (size_t)bits[0] * 73856093u ^ (size_t)bits[1] * 19349663u ^ (size_t)bits[2] * 83492791u;
+            }
+        };
+        std::unordered_map<glm::vec3, uint32_t, PositionHash> firstVertexAtPosition;
+        for (uint32_t i = 0; i < vertices.size(); i++) {
+            auto [it, inserted] = firstVertexAtPosition.emplace(vertices[i].position, i);
+            if (!inserted) {
+                locked[i] = 1;
+                locked[it->second] = 1;
+            }
+        }
+
+        std::unordered_set<uint64_t> edges;
+        edges.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                edges.insert(EdgeKey(indices[i + e], indices[i + (e + 1) % 3]));
+            }
+        }
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                uint32_t a = indices[i + e];
+                uint32_t b = indices[i + (e + 1) % 3];
+                if (!edges.count(EdgeKey(b, a))) {
+                    locked[a] = 1;
+                    locked[b] = 1;
+                }
+            }
+        }
+        return locked;
+    }
+
+    glm::vec3 TriangleNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+        return glm::cross(p1 - p0, p2 - p0);
+    }
+
+    // Quadric error simplification by half edge collapse. Vertices are never moved or created, only the index list
+    // changes, so every LOD shares the original vertex buffer. Runs in passes: each pass sorts the cheapest collapse
+    // per vertex and applies as many non overlapping ones as it can. Error is the largest collapse cost as an RMS
+    // distance to the original planes, in model units.
+    std::vector<uint32_t> SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float& error) {
+        error = 0.0f;
+        std::vector<uint32_t> result = indices;
+        if (indices.size() <= targetIndexCount || vertices.empty()) {
+            return result;
+        }
+        std::vector<uint8_t> locked = FindLockedVertices(vertices, indices);
+
+        std::vector<Quadric> quadrics(vertices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const glm::vec3& p0 = vertices[indices[i]].position;
+            const glm::vec3& p1 = vertices[indices[i + 1]].position;
+            const glm::vec3& p2 = vertices[indices[i + 2]].position;
+            glm::vec3 normal = TriangleNormal(p0, p1, p2);
+            float length = glm::length(normal);
+            if (length <= 0.0f) {
+                continue;
+            }
+            normal /= length;
+            double area = length * 0.5;
+            double d = -glm::dot(normal, p0);
+            for (int j = 0; j < 3; j++) {
+                quadrics[indices[i + j]].AddPlane(normal.x, normal.y, normal.z, d, area);
+            }
+        }
+
+        double maxError = 0.0;
+        std::vector<uint32_t> remap(vertices.size());
+        std::vector<uint8_t> touched(vertices.size());
+        std::vector<Collapse> bestCollapses(vertices.size());
+        std::vector<uint32_t> adjacencyOffsets(vertices.size() + 1);
+        std::vector<uint32_t> adjacency;
+
+        while (result.size() > targetIndexCount) {
+            // Cheapest collapse out of every unlocked vertex
+            for (uint32_t i = 0; i < vertices.size(); i++) {
+                bestCollapses[i] = { i, i, std::numeric_limits<double>::max() };
+            }
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (int e = 0; e < 3; e++) {
+                    uint32_t from = result[i + e];
+                    if (locked[from]) {
+                        continue;
+                    }
+                    for (int o = 1; o < 3; o++) {
+                        uint32_t to = result[i + (e + o) % 3];
+                        Quadric quadric = quadrics[from];
+                        quadric.Add(quadrics[to]);
+                        double cost = quadric.Evaluate(vertices[to].position);
+                        if (cost < bestCollapses[from].cost) {
+                            bestCollapses[from] = { from, to, cost };
+                        }
+                    }
+                }
+            }
+            std::vector<Collapse> collapses;
+            for (const Collapse& collapse : bestCollapses) {
+                if (collapse.from != collapse.to) {
+                    collapses.push_back(collapse);
+                }
+            }
+            if (collapses.empty()) {
+                break;
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+                return a.cost < b.cost;
+            });
+
+            // Vertex to triangle adjacency for the flip test
+            std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+            for (uint32_t index : result) {
+                adjacencyOffsets[index + 1]++;
+            }
+            for (size_t i = 1; i < adjacencyOffsets.size(); i++) {
+                adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+            }
+            adjacency.resize(result.size());
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++) {
+                adjacency[fill[result[i]]++] = (uint32_t)(i / 3);
+            }
+
+            for (uint32_t i = 0; i < vertices.size(); i++) {
+                remap[i] = i;
+            }
+            std::fill(touched.begin(), touched.end(), 0);
+            size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+            size_t trianglesRemoved = 0;
+            size_t collapseCount = 0;
+
+            for (const Collapse& collapse : collapses) {
+                if (trianglesRemoved >= trianglesToRemove) {
+                    break;
+                }
+                if (touched[collapse.from] || touched[collapse.to]) {
+                    continue;
+                }
+                // Reject collapses that would flip a surviving triangle
+                bool flips = false;
+                size_t removedHere = 0;
+                for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+                    const uint32_t* triangle = &result[adjacency[a] * 3];
+                    if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                        removedHere++;
+                        continue;
+                    }
+                    glm::vec3 before[3];
+                    glm::vec3 after[3];
+                    for (int j = 0; j < 3; j++) {
+                        before[j] = vertices[triangle[j]].position;
+                        after[j] = (triangle[j] == collapse.from) ? vertices[collapse.to].position : before[j];
+                    }
+                    if (glm::dot(TriangleNormal(before[0], before[1], before[2]), TriangleNormal(after[0], after[1], after[2])) <= 0.0f) {
+                        flips = true;
+                        break;
+                    }
+                }
+                if (flips || removedHere == 0) {
+                    continue;
+                }
+                remap[collapse.from] = collapse.to;
+                for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+                    const uint32_t* triangle = &result[adjacency[a] * 3];
+                    touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+                }
+                quadrics[collapse.to].Add(quadrics[collapse.from]);
+                const Quadric& quadric = quadrics[collapse.to];
+                maxError = std::max(maxError, quadric.weight > 0.0 ? collapse.cost / quadric.weight : 0.0);
+                trianglesRemoved += removedHere;
+                collapseCount++;
+            }
+            if (collapseCount == 0) {
+                break;
+            }
+
+            // Apply the pass and drop the triangles that collapsed to a line
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3) {
+                uint32_t a = remap[result[i]];
+                uint32_t b = remap[result[i + 1]];
+                uint32_t c = remap[result[i + 2]];
+                if (a == b || b == c || a == c) {
+                    continue;
+                }
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+        error = (float)std::sqrt(maxError);
+        return result;
+    }
+
+    // Each level targets half the triangles of the one before. Levels that barely simplify are not worth the memory,
+    // so generation stops there. Errors are summed, each level is simplified from the previous one.
+    void GenerateLods(MeshData& meshData, int maxLodCount) {
+        meshData.lods.clear();
+        float error = 0.0f;
+        for (int i = 0; i < maxLodCount; i++) {
+            const std::vector<uint32_t>& source = meshData.lods.empty() ? meshData.indices : meshData.lods.back().indices;
+            size_t targetIndexCount = (source.size() / 6) * 3;
+            if (targetIndexCount < 64 * 3) {
+                break;
+            }
+            float lodError = 0.0f;
+            std::vector<uint32_t> lodIndices = SimplifyMesh(meshData.vertices, source, targetIndexCount, lodError);
+            if (lodIndices.size() > source.size() * 9 / 10) {
+                break;
+            }
+            error += lodError;
+            MeshLod& lod = meshData.lods.emplace_back();
+            lod.indices = std::move(lodIndices);
+            lod.error = error;
+        }
+    }
+
+    // Post transform cache modelled as a FIFO, which is what the hardware is closest to
+    constexpr int VERTEX_CACHE_SIZE = 16;
+
+    VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize) {
+        VertexCacheStats stats;
+        if (indices.empty() || vertexCount == 0) {
+            return stats;
+        }
+        // A vertex is cached if fewer than cacheSize misses happened since it was last loaded
+        std::vector<uint32_t> loadedAt(vertexCount, 0);
+        std::vector<uint8_t> referenced(vertexCount, 0);
+        uint32_t misses = 0;
+        uint32_t uniqueVertices = 0;
+        for (uint32_t index : indices) {
+            if (!referenced[index]) {
+                referenced[index] = 1;
+                uniqueVertices++;
+            }
+            if (loadedAt[index] == 0 || misses - loadedAt[index] >= (uint32_t)cacheSize) {
+                misses++;
+                loadedAt[index] = misses;
+            }
+        }
+        stats.acmr = (float)misses / (float)(indices.size() / 3);
+        stats.atvr = (float)misses / (float)uniqueVertices;
+        return stats;
+    }
+
+    // Tipsify (Sander, Nehab, Barczak 2007). Fans around one vertex at a time, moving to whichever vertex of the last
+    // fan will still be in the cache when it is processed. Clusters receives the first triangle of every run that
+    // started from a dead end, these runs are independent in cache terms and can be reordered freely for overdraw.
+    std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>* clusters) {
+        std::vector<uint32_t> result;
+        if (clusters) {
+            clusters->clear();
+        }
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || vertexCount == 0) {
+            return indices;
+        }
+        result.reserve(indices.size());
+
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (uint32_t index : indices) {
+            liveTriangles[index]++;
+        }
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < vertexCount; i++) {
+            adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveTriangles[i];
+        }
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> deadEnds;
+        std::vector<uint32_t> candidates;
+        uint32_t time = VERTEX_CACHE_SIZE + 1;
+        uint32_t cursor = 0;
+        int64_t fanVertex = 0;
+        if (clusters) {
+            clusters->push_back(0);
+        }
+
+        while (fanVertex >= 0) {
+            candidates.clear();
+            for (uint32_t a = adjacencyOffsets[fanVertex]; a < adjacencyOffsets[fanVertex + 1]; a++) {
+                uint32_t triangle = adjacency[a];
+                if (emitted[triangle]) {
+                    continue;
+                }
+                for (int j = 0; j < 3; j++) {
+                    uint32_t vertex = indices[triangle * 3 + j];
+                    result.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveTriangles[vertex]--;
+                    if (time - cacheTime[vertex] > VERTEX_CACHE_SIZE) {
+                        cacheTime[vertex] = time++;
+                    }
+                }
+                emitted[triangle] = 1;
+            }
+
+            // Prefer the candidate that has been in the cache longest while still fitting its remaining fan
+            int64_t nextVertex = -1;
+            int64_t bestPriority = -1;
+            for (uint32_t vertex : candidates) {
+                if (liveTriangles[vertex] == 0) {
+                    continue;
+                }
+                int64_t priority = 0;
+                if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= VERTEX_CACHE_SIZE) {
+                    priority = time - cacheTime[vertex];
+                }
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    nextVertex = vertex;
+                }
+            }
+            // Dead end, restart from the most recent vertex with triangles left, or the next one in input order
+            if (nextVertex == -1) {
+                while (!deadEnds.empty()) {
+                    uint32_t vertex = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (liveTriangles[vertex] > 0) {
+                        nextVertex = vertex;
+                        break;
+                    }
+                }
+                while (nextVertex == -1 && cursor < vertexCount) {
+                    if (liveTriangles[cursor] > 0) {
+                        nextVertex = cursor;
+                    }
+                    cursor++;
+                }
+                uint32_t triangle = (uint32_t)(result.size() / 3);
+                if (nextVertex != -1 && clusters && clusters->back() != triangle) {
+                    clusters->push_back(triangle);
+                }
+            }
+            fanVertex = nextVertex;
+        }
+        return result;
+    }
+
+    // Sander et al. "Fast triangle reordering for vertex locality and reduced overdraw". Clusters are split further
+    // wherever the cache behaviour allows it, then drawn in order of how outward facing they are relative to the mesh
+    // center, so the parts of the mesh most likely to occlude the rest go first.
+    std::vector<uint32_t> OptimizeOverdraw(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusters, float threshold) {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || clusters.empty()) {
+            return indices;
+        }
+
+        // Soft boundaries, a new cluster starts once the one so far is no worse than threshold times its hard cluster's ACMR
+        std::vector<uint32_t> softClusters;
+        std::vector<uint32_t> loadedAt(vertices.size(), 0);
+        uint32_t misses = 0;
+        auto triangleMisses = [&](size_t triangle) {
+            uint32_t count = 0;
+            for (int j = 0; j < 3; j++) {
+                uint32_t vertex = indices[triangle * 3 + j];
+                if (loadedAt[vertex] == 0 || misses - loadedAt[vertex] >= VERTEX_CACHE_SIZE) {
+                    misses++;
+                    loadedAt[vertex] = misses;
+                    count++;
+                }
+            }
+            return count;
+        };
+        auto resetCache = [&]() {
+            misses += VERTEX_CACHE_SIZE;
+        };
+        for (size_t c = 0; c < clusters.size(); c++) {
+            size_t start = clusters[c];
+            size_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : triangleCount;
+            resetCache();
+            uint32_t clusterMisses = 0;
+            for (size_t t = start; t < end; t++) {
+                clusterMisses += triangleMisses(t);
+            }
+            float clusterAcmr = (float)clusterMisses / (float)(end - start);
+
+            resetCache();
+            softClusters.push_back((uint32_t)start);
+            size_t softStart = start;
+            uint32_t softMisses = 0;
+            for (size_t t = start; t < end; t++) {
+                softMisses += triangleMisses(t);
+                if (t + 1 < end && (float)softMisses / (float)(t + 1 - softStart) <= clusterAcmr * threshold) {
+                    softClusters.push_back((uint32_t)(t + 1));
+                    softStart = t + 1;
+                    softMisses = 0;
+                    resetCache();
+                }
+            }
+        }
+
+        glm::vec3 meshCenter = glm::vec3(0);
+        float meshArea = 0.0f;
+        std::vector<glm::vec3> clusterCenters(softClusters.size(), glm::vec3(0));
+        std::vector<glm::vec3> clusterNormals(softClusters.size(), glm::vec3(0));
+        for (size_t c = 0; c < softClusters.size(); c++) {
+            size_t start = softClusters[c];
+            size_t end = (c + 1 < softClusters.size()) ? softClusters[c + 1] : triangleCount;
+            float clusterArea = 0.0f;
+            for (size_t t = start; t < end; t++) {
+                const glm::vec3& p0 = vertices[indices[t * 3]].position;
+                const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+                const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+                glm::vec3 normal = TriangleNormal(p0, p1, p2);
+                float area = glm::length(normal);
+                glm::vec3 center = (p0 + p1 + p2) / 3.0f;
+                clusterCenters[c] += center * area;
+                clusterNormals[c] += normal;
+                clusterArea += area;
+                meshCenter += center * area;
+                meshArea += area;
+            }
+            if (clusterArea > 0.0f) {
+                clusterCenters[c] /= clusterArea;
+            }
+            float normalLength = glm::length(clusterNormals[c]);
+            if (normalLength > 0.0f) {
+                clusterNormals[c] /= normalLength;
+            }
+        }
+        if (meshArea > 0.0f) {
+            meshCenter /= meshArea;
+        }
+
+        std::vector<uint32_t> order(softClusters.size());
+        std::vector<float> sortKeys(softClusters.size());
+        for (size_t c = 0; c < softClusters.size(); c++) {
+            order[c] = (uint32_t)c;
+            sortKeys[c] = glm::dot(clusterCenters[c] - meshCenter, clusterNormals[c]);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return sortKeys[a] > sortKeys[b];
+        });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t c : order) {
+            size_t start = softClusters[c];
+            size_t end = (c + 1 < softClusters.size()) ? softClusters[c + 1] : triangleCount;
+            result.insert(result.end(), indices.begin() + start * 3, indices.begin() + end * 3);
+        }
+        return result;
+    }
+
+    // Renumbers vertices in the order the index list first touches them so fetches walk the vertex buffer forwards.
+    // Unreferenced vertices are kept at the end. Returns the old to new index remap so other index lists can follow.
+    std::vector<uint32_t> OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        const uint32_t unassigned = 0xFFFFFFFF;
+        std::vector<uint32_t> remap(vertices.size(), unassigned);
+        uint32_t nextVertex = 0;
+        for (uint32_t& index : indices) {
+            if (remap[index] == unassigned) {
+                remap[index] = nextVertex++;
+            }
+            index = remap[index];
+        }
+        for (uint32_t& newIndex : remap) {
+            if (newIndex == unassigned) {
+                newIndex = nextVertex++;
+            }
+        }
+        std::vector<Vertex> remappedVertices(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            remappedVertices[remap[i]] = vertices[i];
+        }
+        vertices = std::move(remappedVertices);
+        return remap;
+    }
+
+    // Export time optimization of a mesh and its LODs: cache order, then overdraw order, then fetch order
+    void OptimizeMesh(MeshData& meshData) {
+        size_t vertexCount = meshData.vertices.size();
+        std::vector<uint32_t> clusters;
+        meshData.indices = OptimizeVertexCache(meshData.indices, vertexCount, &clusters);
+        meshData.indices = OptimizeOverdraw(meshData.vertices, meshData.indices, clusters);
+        for (MeshLod& lod : meshData.lods) {
+            lod.indices = OptimizeVertexCache(lod.indices, vertexCount, &clusters);
+            lod.indices = OptimizeOverdraw(meshData.vertices, lod.indices, clusters);
+        }
+        std::vector<uint32_t> remap = OptimizeVertexFetch(meshData.vertices, meshData.indices);
+        for (MeshLod& lod : meshData.lods) {
+            for (uint32_t& index : lod.indices) {
+                index = remap[index];
+            }
+        }
+    }
+
+    // Bounding sphere and normal cone of the triangles in [indexOffset, indexOffset + indexCount)
+    void ComputeMeshletBounds(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Meshlet& meshlet) {
+        glm::vec3 aabbMin = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 aabbMax = glm::vec3(-std::numeric_limits<float>::max());
+        glm::vec3 normalSum = glm::vec3(0);
+        std::vector<glm::vec3> normals;
+        for (uint32_t i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; i += 3) {
+            const glm::vec3& p0 = vertices[indices[i]].position;
+            const glm::vec3& p1 = vertices[indices[i + 1]].position;
+            const glm::vec3& p2 = vertices[indices[i + 2]].position;
+            aabbMin = glm::min(aabbMin, glm::min(p0, glm::min(p1, p2)));
+            aabbMax = glm::max(aabbMax, glm::max(p0, glm::max(p1, p2)));
+            glm::vec3 normal = TriangleNormal(p0, p1, p2);
+            float length = glm::length(normal);
+            if (length > 0.0f) {
+                normals.push_back(normal / length);
+                normalSum += normals.back();
+            }
+        }
+        meshlet.center = (aabbMin + aabbMax) * 0.5f;
+        meshlet.radius = 0.0f;
+        for (uint32_t i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; i++) {
+            meshlet.radius = std::max(meshlet.radius, glm::length(vertices[indices[i]].position - meshlet.center));
+        }
+
+        // A cutoff of 1 can never pass the test, used when the normals spread over a hemisphere or more
+        meshlet.coneAxis = glm::vec3(0, 0, 1);
+        meshlet.coneCutoff = 1.0f;
+        float axisLength = glm::length(normalSum);
+        if (axisLength <= 0.0f) {
+            return;
+        }
+        meshlet.coneAxis = normalSum / axisLength;
+        float minDot = 1.0f;
+        for (const glm::vec3& normal : normals) {
+            minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+        }
+        if (minDot > 0.0f) {
+            meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+    }
+
+    // Splits the index list into runs of at most MESHLET_MAX_VERTICES unique vertices and MESHLET_MAX_TRIANGLES
+    // triangles without reordering anything, so a meshlet can be drawn straight out of the existing index buffer.
+    // Run after OptimizeMesh, the cache ordering already keeps neighbouring triangles together.
+    std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        std::vector<Meshlet> meshlets;
+        if (indices.empty()) {
+            return meshlets;
+        }
+        std::vector<uint32_t> meshletStamp(vertices.size(), 0xFFFFFFFF);
+        Meshlet current = {};
+        uint32_t currentVertexCount = 0;
+
+        auto finishMeshlet = [&]() {
+            if (current.indexCount > 0) {
+                ComputeMeshletBounds(vertices, indices, current);
+                meshlets.push_back(current);
+            }
+            current = {};
+            current.indexOffset = (uint32_t)(meshlets.empty() ? 0 : meshlets.back().indexOffset + meshlets.back().indexCount);
+            currentVertexCount = 0;
+        };
+
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            uint32_t meshletIndex = (uint32_t)meshlets.size();
+            uint32_t newVertexCount = 0;
+            for (int j = 0; j < 3; j++) {
+                uint32_t vertex = indices[i + j];
+                bool repeated = (j > 0 && indices[i] == vertex) || (j > 1 && indices[i + 1] == vertex);
+                if (meshletStamp[vertex] != meshletIndex && !repeated) {
+                    newVertexCount++;
+                }
+            }
+            if (currentVertexCount + newVertexCount > MESHLET_MAX_VERTICES || current.indexCount / 3 >= MESHLET_MAX_TRIANGLES) {
+                finishMeshlet();
+                meshletIndex = (uint32_t)meshlets.size();
+                newVertexCount = 0;
+                for (int j = 0; j < 3; j++) {
+                    if (meshletStamp[indices[i + j]] != meshletIndex) {
+                        meshletStamp[indices[i + j]] = meshletIndex;
+                        newVertexCount++;
+                    }
+                }
+            }
+            else {
+                for (int j = 0; j < 3; j++) {
+                    meshletStamp[indices[i + j]] = meshletIndex;
+                }
+            }
+            currentVertexCount += newVertexCount;
+            current.indexCount += 3;
+        }
+        finishMeshlet();
+        return meshlets;
+    }
+
+    // Octahedral encoding, the unit sphere folded onto the [-1, 1] square
+    glm::vec2 OctahedralEncode(glm::vec3 n) {
+        float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (!(sum > 0.0f)) {
+            return glm::vec2(0.0f);
+        }
+        n /= sum;
+        glm::vec2 encoded = glm::vec2(n.x, n.y);
+        if (n.z < 0.0f) {
+            encoded.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+            encoded.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return encoded;
+    }
+
+    glm::vec3 OctahedralDecode(glm::vec2 e) {
+        glm::vec3 n = glm::vec3(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        if (n.z < 0.0f) {
+            float x = n.x;
+            n.x = (1.0f - std::abs(n.y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            n.y = (1.0f - std::abs(x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return glm::normalize(n);
+    }
+
+    // x and y of a GL_INT_2_10_10_10_REV word, z and w left at zero
+    uint32_t PackSnorm10x2(glm::vec2 v) {
+        int32_t x = (int32_t)std::round(std::clamp(v.x, -1.0f, 1.0f) * 511.0f);
+        int32_t y = (int32_t)std::round(std::clamp(v.y, -1.0f, 1.0f) * 511.0f);
+        return ((uint32_t)x & 0x3FF) | (((uint32_t)y & 0x3FF) << 10);
+    }
+
+    glm::vec2 UnpackSnorm10x2(uint32_t packed) {
+        int32_t x = (int32_t)(packed << 22) >> 22;
+        int32_t y = (int32_t)(packed << 12) >> 22;
+        return glm::vec2(std::max(x / 511.0f, -1.0f), std::max(y / 511.0f, -1.0f));
+    }
+
+    CompactVertex QuantizeVertex(const Vertex& vertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        CompactVertex compactVertex = {};
+        glm::vec3 extent = aabbMax - aabbMin;
+        for (int i = 0; i < 3; i++) {
+            float t = (extent[i] > 0.0f) ? (vertex.position[i] - aabbMin[i]) / extent[i] : 0.0f;
+            compactVertex.position[i] = (uint16_t)std::round(std::clamp(t, 0.0f, 1.0f) * 65535.0f);
+        }
+        compactVertex.normal = PackSnorm10x2(OctahedralEncode(vertex.normal));
+        compactVertex.tangent = PackSnorm10x2(OctahedralEncode(vertex.tangent));
+        compactVertex.uv[0] = glm::packHalf1x16(vertex.uv.x);
+        compactVertex.uv[1] = glm::packHalf1x16(vertex.uv.y);
+        return compactVertex;
+    }
+
+    Vertex DequantizeVertex(const CompactVertex& compactVertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        Vertex vertex;
+        glm::vec3 extent = aabbMax - aabbMin;
+        for (int i = 0; i < 3; i++) {
+            vertex.position[i] = aabbMin[i] + (compactVertex.position[i] / 65535.0f) * extent[i];
+        }
+        vertex.normal = OctahedralDecode(UnpackSnorm10x2(compactVertex.normal));
+        vertex.tangent = OctahedralDecode(UnpackSnorm10x2(compactVertex.tangent));
+        vertex.uv = glm::vec2(glm::unpackHalf1x16(compactVertex.uv[0]), glm::unpackHalf1x16(compactVertex.uv[1]));
+        return vertex;
+    }
+
+    std::vector<CompactVertex> QuantizeVertices(const std::vector<Vertex>& vertices, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        std::vector<CompactVertex> compactVertices(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            compactVertices[i] = QuantizeVertex(vertices[i], aabbMin, aabbMax);
+        }
+        return compactVertices;
+    }
+
+    std::vector<Vertex> DequantizeVertices(const std::vector<CompactVertex>& compactVertices, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        std::vector<Vertex> vertices(compactVertices.size());
+        for (size_t i = 0; i < compactVertices.size(); i++) {
+            vertices[i] = DequantizeVertex(compactVertices[i], aabbMin, aabbMax);
+        }
+        return vertices;
+    }
+}
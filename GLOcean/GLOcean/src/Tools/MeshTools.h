@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include "HellTypes.h"
+#include "../File/FileFormats.h"
+
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+constexpr uint32_t MESHLET_MIN_MESH_TRIANGLES = 1024; // Below this a mesh is drawn whole
+
+struct VertexCacheStats {
+    float acmr = 0.0f; // Vertex shader invocations per triangle
+    float atvr = 0.0f; // Vertex shader invocations per unique vertex
+};
+
+namespace MeshTools {
+    // Simplification
+    std::vector<uint32_t> SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float& error);
+    void GenerateLods(MeshData& meshData, int maxLodCount = 3);
+
+    // Quantization
+    CompactVertex QuantizeVertex(const Vertex& vertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax);
+    Vertex DequantizeVertex(const CompactVertex& compactVertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax);
+    std::vector<CompactVertex> QuantizeVertices(const std::vector<Vertex>& vertices, const glm::vec3& aabbMin, const glm::vec3& aabbMax);
+    std::vector<Vertex> DequantizeVertices(const std::vector<CompactVertex>& compactVertices, const glm::vec3& aabbMin, const glm::vec3& aabbMax);
+
+    // Optimization
+    std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>* clusters = nullptr);
+    std::vector<uint32_t> OptimizeOverdraw(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusters, float threshold = 1.05f);
+    std::vector<uint32_t> OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+    void OptimizeMesh(MeshData& meshData);
+    std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+    VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize = 16);
+}
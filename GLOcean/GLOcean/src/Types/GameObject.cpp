@@ -3,10 +3,25 @@
 
 void GameObject::SetPosition(glm::vec3 position) {
     m_transform.position = position;
+    MarkTransformDirty();
 }
 
 void GameObject::SetRotationY(float rotation) {
     m_transform.rotation.y = rotation;
+    MarkTransformDirty();
+}
+
+void GameObject::MarkRenderItemsDirty() {
+    m_renderItemsDirty = true;
+}
+
+void GameObject::SetParent(GameObject* parent) {
+    TransformSystem::SetParent(m_transformIndex, parent ? parent->m_transformIndex : TransformSystem::NO_PARENT);
+}
+
+void GameObject::MarkTransformDirty() {
+    TransformSystem::SetLocalTransform(m_transformIndex, m_transform);
+    m_transformDirty = true;
 }
 
 void GameObject::SetModel(const std::string& name) {
@@ -22,6 +37,7 @@ void GameObject::SetModel(const std::string& name) {
     for (BlendingMode& blendingMode : m_meshBlendingModes) {
         blendingMode = BlendingMode::NONE;
     }
+    MarkRenderItemsDirty();
 }
 
 void GameObject::SetMeshMaterialByMeshName(std::string meshName, const char* materialName) {
@@ -29,7 +45,10 @@ void GameObject::SetMeshMaterialByMeshName(std::string meshName, const char* mat
     if (m_model && materialIndex != -1) {
         for (int i = 0; i < m_model->GetMeshCount(); i++) {
             if (AssetManager::GetMeshByIndex(m_model->GetMeshIndices()[i])->GetName() == meshName) {
-                m_meshMaterialIndices[i] = materialIndex;
+                if (m_meshMaterialIndices[i] != materialIndex) {
+                    m_meshMaterialIndices[i] = materialIndex;
+                    MarkRenderItemsDirty();
+                }
                 return;
             }
         }
@@ -58,6 +77,7 @@ void GameObject::SetMeshBlendingMode(const char* meshName, BlendingMode blending
             if (mesh && mesh->GetName() == meshName) {
                 m_meshBlendingModes[i] = blendingMode;
                 found = true;
+                MarkRenderItemsDirty();
             }
         }
         if (!found) {
@@ -72,6 +92,7 @@ void GameObject::SetMeshBlendingModes(BlendingMode blendingMode) {
             OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(m_model->GetMeshIndices()[i]);
             if (mesh) {
                 m_meshBlendingModes[i] = blendingMode;
+                MarkRenderItemsDirty();
             }
         }
     }
@@ -93,7 +114,11 @@ void GameObject::PrintMeshNames() {
     }
 }
 
+// Rebuilds the per object lists, only needed once m_renderItemsDirty is set
 void GameObject::UpdateRenderItems() {
+    m_modelMatrix = TransformSystem::GetWorldMatrix(m_transformIndex);
+    m_renderItemsDirty = false;
+    m_transformDirty = false;
     m_renderItems.clear();
     m_renderItemsBlended.clear();
     m_renderItemsAlphaDiscarded.clear();
@@ -104,10 +129,11 @@ void GameObject::UpdateRenderItems() {
             OpenGLDetachedMesh* mesh = AssetManager::GetMeshByIndex(m_model->GetMeshIndices()[i]);
             if (mesh) {
                 RenderItem renderItem;
-                renderItem.modelMatrix = m_transform.to_mat4();
+                renderItem.modelMatrix = m_modelMatrix;
                 renderItem.meshIndex = m_model->GetMeshIndices()[i];
                 Material* material = AssetManager::GetMaterialByIndex(m_meshMaterialIndices[i]);
                 if (material) {
+                    renderItem.materialIndex = m_meshMaterialIndices[i];
                     renderItem.baseColorTextureIndex = material->m_basecolor;
                     renderItem.normalTextureIndex = material->m_normal;
                     renderItem.rmaTextureIndex = material->m_rma;
@@ -126,6 +152,17 @@ void GameObject::UpdateRenderItems() {
     }
 }
 
+// Transform only change, recomputes the matrix once and patches it into the existing items
+void GameObject::UpdateModelMatrix() {
+    m_modelMatrix = TransformSystem::GetWorldMatrix(m_transformIndex);
+    m_transformDirty = false;
+    for (std::vector<RenderItem>* renderItems : { &m_renderItems, &m_renderItemsBlended, &m_renderItemsAlphaDiscarded, &m_renderItemsHairTopLayer, &m_renderItemsHairBottomLayer }) {
+        for (RenderItem& renderItem : *renderItems) {
+            renderItem.modelMatrix = m_modelMatrix;
+        }
+    }
+}
+
 std::vector<RenderItem>& GameObject::GetRenderItems() {
     return m_renderItems;
 }
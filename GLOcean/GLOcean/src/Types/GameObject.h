@@ -1,23 +1,32 @@
 #pragma once
 #include "HellTypes.h"
 #include "Model.hpp"
+#include "../Core/TransformSystem.hpp"
 
 struct GameObject {
     std::string m_name;
     Model* m_model = nullptr;
-    Transform m_transform;
+    Transform m_transform;            // Authored local transform, pushed to the transform system by MarkTransformDirty()
+    uint32_t m_transformIndex = TransformSystem::INVALID_INDEX; // Allocated by Scene::CreateGameObject()
     std::vector<BlendingMode> m_meshBlendingModes;
     std::vector<int> m_meshMaterialIndices;
+    glm::mat4 m_modelMatrix = glm::mat4(1);
+    bool m_renderItemsDirty = true;   // Model, material or blending mode changed, the render lists need rebuilding
+    bool m_transformDirty = true;     // Only the model matrix changed, existing render items are patched in place
 
     void SetName(const std::string& name);
     void SetPosition(glm::vec3 position);
     void SetRotationY(float rotation);
+    void SetParent(GameObject* parent);
     void SetModel(const std::string& name);
     void SetMeshMaterialByMeshName(std::string meshName, const char* materialName);
     void SetMeshBlendingMode(const char* meshName, BlendingMode blendingMode);
     void SetMeshBlendingModes(BlendingMode blendingMode);
     void PrintMeshNames();
+    void MarkRenderItemsDirty();
+    void MarkTransformDirty();
     void UpdateRenderItems();
+    void UpdateModelMatrix();
 
     std::vector<RenderItem>& GetRenderItems();
     std::vector<RenderItem>& GetRenderItemsBlended();